@@ -0,0 +1,75 @@
+#pragma once
+
+#include <eosio/datastream.hpp>
+#include <eosio/name.hpp>
+#include <eosio/singleton.hpp>
+
+#include <vector>
+
+namespace eosiocommon {
+
+   /**
+    * Singleton that only writes back values that changed.
+    *
+    * @details Shared by the system contract and eosio.trail. Contracts commonly load their state singletons in the constructor and store them
+    * again in the destructor. `tracked_singleton` keeps the serialized form of the last value it
+    * read or wrote, and `set` skips the database update when the new value serializes to the same
+    * bytes, so actions that do not touch a given singleton do not pay for rewriting it.
+    *
+    * @tparam SingletonName - the name of the singleton table,
+    * @tparam T - the type of the stored value.
+    */
+   template<eosio::name::raw SingletonName, typename T>
+   class tracked_singleton {
+      public:
+         tracked_singleton( eosio::name code, uint64_t scope ) : _singleton( code, scope ) {}
+
+         bool exists() {
+            return _singleton.exists();
+         }
+
+         T get() {
+            T value = _singleton.get();
+            track( value );
+            return value;
+         }
+
+         T get_or_create( eosio::name payer, const T& def = T() ) {
+            if( _singleton.exists() ) {
+               return get();
+            }
+            set( def, payer );
+            return def;
+         }
+
+         /**
+          * Stores `value` unless it serializes to the last value read or written.
+          */
+         void set( const T& value, eosio::name payer ) {
+            auto packed = eosio::pack( value );
+            if( packed == _packed ) {
+               return;
+            }
+            _singleton.set( value, payer );
+            _packed = std::move( packed );
+         }
+
+         /**
+          * Treats `value` as the stored state without writing it. Used for fields that are
+          * refreshed on every load but are not worth a database update on their own.
+          */
+         void track( const T& value ) {
+            _packed = eosio::pack( value );
+         }
+
+         void remove() {
+            _singleton.remove();
+            _packed.clear();
+         }
+
+      private:
+         eosio::singleton<SingletonName, T> _singleton;
+         std::vector<char>                  _packed;
+   };
+
+} /// eosiocommon
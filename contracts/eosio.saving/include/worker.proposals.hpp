@@ -56,6 +56,16 @@ class[[eosio::contract("eosio.saving")]] workerproposal : public contract
 	};
 	wp_env wp_env_struct;
 
+	// one entry of an eosio.token bulktransfer
+	struct token_transfer
+	{
+		name to;
+		asset quantity;
+		std::string memo;
+
+		EOSLIB_SERIALIZE(token_transfer, (to)(quantity)(memo))
+	};
+
 	typedef eosio::multi_index<"submissions"_n, submission> submissions_table;
 	typedef eosio::multi_index<"deposits"_n, deposit> deposits_table;
 	typedef singleton<"wpenv"_n, wp_env> wp_environment_singleton;
@@ -80,4 +90,9 @@ class[[eosio::contract("eosio.saving")]] workerproposal : public contract
 
 	[[eosio::on_notify("eosio.token::transfer")]]
 	void transfer_handler(name from, name to, asset quantity, string memo);
+
+	[[eosio::on_notify("eosio.token::bulktransfer")]]
+	void bulktransfer_handler(name from, vector<token_transfer> transfers);
+
+	void add_deposit(name owner, asset quantity);
 };
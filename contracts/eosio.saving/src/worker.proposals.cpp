@@ -264,13 +264,30 @@ void workerproposal::transfer_handler(name from, name to, asset quantity, string
 		return;
 	}
 
+	add_deposit(from, quantity);
+
+	print("\nDeposit Complete");
+}
+
+// the entries of a bulktransfer paid to eosio.saving are deposits of the sender, like a transfer
+void workerproposal::bulktransfer_handler(name from, vector<token_transfer> transfers) {
+	require_auth(from);
+
+	for(const auto& t : transfers) {
+		if(t.to == _self) {
+			add_deposit(from, t.quantity);
+		}
+	}
+}
+
+void workerproposal::add_deposit(name owner, asset quantity) {
 	if(quantity.symbol == symbol("TLOS", 4)) {
 		deposits_table deposits(_self, _self.value);
-		auto d = deposits.find(from.value);
+		auto d = deposits.find(owner.value);
 
 		if(d == deposits.end()) {
 			deposits.emplace(get_self(), [&](auto& depo) {
-				depo.owner = from;
+				depo.owner = owner;
 				depo.escrow = quantity;
 			});
 		} else {
@@ -279,6 +296,4 @@ void workerproposal::transfer_handler(name from, name to, asset quantity, string
 			});
 		}
 	}
-
-	print("\nDeposit Complete");
 }
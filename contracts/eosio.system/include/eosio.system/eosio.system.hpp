@@ -1,6 +1,7 @@
 #pragma once
 
 #include <eosio/asset.hpp>
+#include <eosio/binary_extension.hpp>
 #include <eosio/privileged.hpp>
 #include <eosio/singleton.hpp>
 #include <eosio/system.hpp>
@@ -8,12 +9,16 @@
 
 #include <eosio.system/exchange_state.hpp>
 #include <eosio.system/native.hpp>
+#include <eosio.common/tracked_singleton.hpp>
 
+#include <boost/container/flat_map.hpp>
+
+#include <algorithm>
 #include <cmath>
 #include <string>
+#include <tuple>
 #include <type_traits>
 #include <optional>
-#include <deque>
 #include <type_traits>
 #include <optional>
 
@@ -40,6 +45,7 @@ namespace eosiosystem {
    using eosio::time_point;
    using eosio::time_point_sec;
    using eosio::unsigned_int;
+   using eosiocommon::tracked_singleton;
 
    static constexpr uint32_t seconds_per_year      = 52 * 7 * 24 * 3600;
    static constexpr uint32_t seconds_per_day       = 24 * 3600;
@@ -75,17 +81,92 @@ namespace eosiosystem {
 
    typedef eosio::multi_index< "payments"_n, payment_info > payments_table;
 
+   /**
+    * Reward index state.
+    *
+    * @details Producer pay is accounted with a per-share index instead of per-producer payments:
+    * - `pay_per_share` the pay of one share, accumulated over every rewards snapshot,
+    * - `last_snapshot` the time of the last rewards snapshot,
+    * - `shareholders` the producers paid by the last snapshot, in rank order. The first 21 hold
+    * two shares, the others one.
+    *
+    * A snapshot only raises `pay_per_share` and updates the `prodrewards` rows of producers whose
+    * share count changed, `claimrewards` computes what is owed from the index.
+    */
+   struct[[ eosio::table("rewardindex"), eosio::contract("eosio.system") ]] reward_index_state {
+     int64_t pay_per_share = 0;
+     time_point last_snapshot;
+     std::vector<name> shareholders;
+
+     EOSLIB_SERIALIZE(reward_index_state, (pay_per_share)(last_snapshot)(shareholders))
+   };
+
+   typedef eosio::singleton< "rewardindex"_n, reward_index_state > reward_index_singleton;
+
+   /**
+    * Producer reward.
+    *
+    * @details Pay accounting of a producer against the reward index:
+    * - `owner` the producer,
+    * - `shares` the shares held since `pay_index`,
+    * - `pay_index` the value of `pay_per_share` the producer was last settled at,
+    * - `unclaimed` pay settled and not yet claimed.
+    *
+    * The producer is owed `unclaimed + shares * (pay_per_share - pay_index)`.
+    */
+   struct[[ eosio::table, eosio::contract("eosio.system") ]] producer_reward {
+     name owner;
+     uint8_t shares = 0;
+     int64_t pay_index = 0;
+     int64_t unclaimed = 0;
+
+     uint64_t primary_key() const { return owner.value; }
+     EOSLIB_SERIALIZE(producer_reward, (owner)(shares)(pay_index)(unclaimed))
+   };
+
+   typedef eosio::multi_index< "prodrewards"_n, producer_reward > producer_rewards_table;
+
+   /**
+    * Token supply mirror.
+    *
+    * @details Core token supply, seeded from eosio.token and then kept current from the issue and
+    * retire notifications eosio.token sends the issuer, so rewards snapshots do not read the token
+    * contract's stats table. Every supply change of the core token notifies the system contract as
+    * its issuer, so the mirror does not drift. `checksupply` compares it with eosio.token and
+    * corrects it, e.g. when eosio.token was updated after the mirror was seeded.
+    */
+   struct[[ eosio::table("tokenmirror"), eosio::contract("eosio.system") ]] token_mirror_state {
+     asset supply;
+
+     EOSLIB_SERIALIZE(token_mirror_state, (supply))
+   };
+
+   typedef eosio::singleton< "tokenmirror"_n, token_mirror_state > token_mirror_singleton;
+
    struct [[eosio::table("schedulemetr"), eosio::contract("eosio.system")]] schedule_metrics_state {
      name                     last_onblock_caller;
      int32_t                          block_counter_correction;
      std::vector<producer_metric>     producers_metric;
+     eosio::binary_extension<uint32_t> proposed_schedule_version; /// version returned by set_proposed_producers for producers_metric
+     eosio::binary_extension<eosio::checksum256> proposed_schedule_hash; /// sha256 of the packed producer keys last proposed
 
      uint64_t primary_key()const { return last_onblock_caller.value; }
+
+     /**
+      * Returns the metric of `bp`, or nullptr if it is not part of the schedule.
+      * producers_metric is kept sorted by producer name.
+      */
+     producer_metric* find_metric( const name& bp ) {
+        auto itr = std::lower_bound( producers_metric.begin(), producers_metric.end(), bp,
+                                     []( const producer_metric& pm, const name& n ) { return pm.bp_name < n; } );
+        return itr != producers_metric.end() && itr->bp_name == bp ? &*itr : nullptr;
+     }
+
      // explicit serialization macro is not necessary, used here only to improve compilation time
-     EOSLIB_SERIALIZE(schedule_metrics_state, (last_onblock_caller)(block_counter_correction)(producers_metric))
+     EOSLIB_SERIALIZE(schedule_metrics_state, (last_onblock_caller)(block_counter_correction)(producers_metric)(proposed_schedule_version)(proposed_schedule_hash))
    };
 
-   typedef eosio::singleton< "schedulemetr"_n, schedule_metrics_state > schedule_metrics_singleton;
+   typedef tracked_singleton< "schedulemetr"_n, schedule_metrics_state > schedule_metrics_singleton;
 
    struct [[eosio::table("rotations"), eosio::contract("eosio.system")]] rotation_state {
       // bool                            is_rotation_active = true;
@@ -106,7 +187,33 @@ namespace eosiosystem {
                         (last_rotation_time)/*(is_kick_active)(last_onblock_caller)(last_time_block_produced)*/ )
    };
 
-   typedef eosio::singleton< "rotations"_n, rotation_state> rotation_singleton;
+   typedef tracked_singleton< "rotations"_n, rotation_state> rotation_singleton;
+
+   static constexpr uint16_t reconcile_voters_per_block = 50;
+   // a voter can delegate to a proxy, which cannot itself use a proxy
+   static constexpr uint32_t max_proxy_chain_length = 2;
+
+   /**
+    * Vote reconciliation state.
+    *
+    * @details Tracks a bounded rebuild of producer vote tallies from the voters table:
+    * - `active` whether a reconciliation is in progress,
+    * - `epoch` incremented every time a reconciliation starts, voters whose `reserved2` differs
+    *    from it have not been reset yet in the current reconciliation,
+    * - `cursor` the next voter to be replayed,
+    * - `started` the time the current reconciliation started.
+    */
+   struct [[eosio::table("reconcile"), eosio::contract("eosio.system")]] vote_reconcile_state {
+      bool              active = false;
+      uint32_t          epoch = 0;
+      name              cursor;
+      time_point        started;
+
+      EOSLIB_SERIALIZE( vote_reconcile_state, (active)(epoch)(cursor)(started) )
+   };
+
+   typedef tracked_singleton< "reconcile"_n, vote_reconcile_state > vote_reconcile_singleton;
+
    template<typename E, typename F>
    static inline auto has_field( F flags, E field )
    -> std::enable_if_t< std::is_integral_v<F> && std::is_unsigned_v<F> &&
@@ -133,7 +240,7 @@ namespace eosiosystem {
       EOSLIB_SERIALIZE(payrates, (bpay_rate)(worker_amount))
    };
 
-   typedef eosio::singleton< "payrate"_n, payrates > payrate_singleton;
+   typedef tracked_singleton< "payrate"_n, payrates > payrate_singleton;
 
    struct [[eosio::table, eosio::contract("eosio.system")]] name_bid {
      name            newname;
@@ -175,6 +282,14 @@ namespace eosiosystem {
     */
    typedef eosio::multi_index< "bidrefunds"_n, bid_refund > bid_refund_table;
 
+   /**
+    * Bid refund queue.
+    *
+    * @details Outbid amounts waiting to be paid back, one row per bidder across all names, in the
+    * contract scope. Rows are billed to the contract and paid out with `claimrefund`.
+    */
+   typedef eosio::multi_index< "refundqueue"_n, bid_refund > bid_refund_queue;
+
    /**
     * Defines new global state parameters.
     */
@@ -204,6 +319,7 @@ namespace eosiosystem {
       block_timestamp      last_block_num; /* deprecated */
       double               total_producer_votepay_share = 0;
       uint8_t              revision = 0; ///< used to track version updates in the future.
+      eosio::binary_extension<name_bid> top_name_bid; ///< highest open name bid, an empty bid when there is none
 
       // explicit serialization macro is not necessary, used here only to improve compilation time
       EOSLIB_SERIALIZE_DERIVED( eosio_global_state, eosio::blockchain_parameters,
@@ -211,7 +327,7 @@ namespace eosiosystem {
                                 (last_producer_schedule_update)(last_proposed_schedule_update)(last_pervote_bucket_fill)
                                 (pervote_bucket)(perblock_bucket)(total_unpaid_blocks)(total_activated_stake)(thresh_activated_stake_time)
                                 (last_producer_schedule_size)(total_producer_vote_weight)(last_name_close)(block_num)(last_claimrewards)(next_payment)
-                                (new_ram_per_block)(last_ram_increase)(last_block_num)(total_producer_votepay_share)(revision) )
+                                (new_ram_per_block)(last_ram_increase)(last_block_num)(total_producer_votepay_share)(revision)(top_name_bid) )
    };
 
   enum class kick_type {
@@ -230,8 +346,8 @@ namespace eosiosystem {
       bool                  is_active = true;
       std::string           unreg_reason;
       std::string           url;
-      uint32_t              unpaid_blocks = 0;
-      uint32_t              lifetime_produced_blocks = 0;
+      uint32_t              unpaid_blocks = 0; /// blocks produced up to the last rewards snapshot and not claimed yet
+      uint32_t              lifetime_produced_blocks = 0; /// blocks produced up to the last rewards snapshot
       uint32_t              missed_blocks_per_rotation = 0;
       uint32_t              lifetime_missed_blocks = 0;
       time_point            last_claim_time;
@@ -310,7 +426,7 @@ namespace eosiosystem {
 
 
       uint32_t            flags1 = 0;
-      uint32_t            reserved2 = 0;
+      uint32_t            reserved2 = 0; /// vote reconciliation epoch this voter was last reset in
       eosio::asset        reserved3;
       uint64_t primary_key()const { return owner.value; }
 
@@ -331,6 +447,69 @@ namespace eosiosystem {
     */
    typedef eosio::multi_index< "voters"_n, voter_info >  voters_table;
 
+   /**
+    * Vote entry.
+    *
+    * @details One vote of a `votebatch`, with the same meaning as the arguments of `voteproducer`:
+    * - `voter` the account doing the voting,
+    * - `proxy` the proxy to delegate the vote to,
+    * - `producers` the producers voted for.
+    */
+   struct vote_entry {
+      name                voter;
+      name                proxy;
+      std::vector<name>   producers;
+
+      EOSLIB_SERIALIZE( vote_entry, (voter)(proxy)(producers) )
+   };
+
+   /**
+    * Producer vote changes collected by `update_votes`, keyed by producer. The flag is set when
+    * the producer is part of a new vote and therefore must be registered and active.
+    */
+   typedef boost::container::flat_map< name, std::pair< double, bool > > producer_deltas_map;
+
+   /**
+    * Delegator info.
+    *
+    * @details Stored in the scope of a proxy, one row per voter that has set that proxy:
+    * - `voter` the delegating voter
+    *
+    * The voters table predates this index and secondary indices cannot be added to a populated
+    * table, so delegators are tracked in their own table, backfilled by `indexproxied`.
+    */
+   struct [[eosio::table, eosio::contract("eosio.system")]] delegator_info {
+      name                voter;
+
+      uint64_t primary_key()const { return voter.value; }
+
+      // explicit serialization macro is not necessary, used here only to improve compilation time
+      EOSLIB_SERIALIZE( delegator_info, (voter) )
+   };
+
+   /**
+    * Delegators table
+    *
+    * @details The delegators table, scoped by proxy, lists the voters delegating to that proxy.
+    */
+   typedef eosio::multi_index< "delegators"_n, delegator_info > delegators_table;
+
+   /**
+    * Delegators index state.
+    *
+    * @details Tracks the backfill of the delegators table from the voters table:
+    * - `complete` whether every voter has been indexed,
+    * - `cursor` the next voter to be indexed.
+    */
+   struct [[eosio::table("delegidx"), eosio::contract("eosio.system")]] delegators_index_state {
+      bool                complete = false;
+      name                cursor;
+
+      EOSLIB_SERIALIZE( delegators_index_state, (complete)(cursor) )
+   };
+
+   typedef tracked_singleton< "delegidx"_n, delegators_index_state > delegators_index_singleton;
+
 
    /**
     * Defines producer info table added in version 1.0
@@ -339,10 +518,61 @@ namespace eosiosystem {
                                indexed_by<"prototalvote"_n, const_mem_fun<producer_info, double, &producer_info::by_votes>  >
                              > producers_table;
 
+   /**
+    * Vote delta.
+    *
+    * @details Producer vote change not yet added to the producer's `total_votes`:
+    * - `producer` the producer voted for,
+    * - `delta` the sum of the vote weight changes since the last settlement.
+    *
+    * Votes and stake changes only accumulate here, `onblock` folds the deltas into the producers
+    * table before producers are ranked, so `total_votes` trails the latest votes by at most a minute.
+    * Clients wanting the current tally add `delta` to `total_votes`.
+    */
+   struct [[eosio::table, eosio::contract("eosio.system")]] vote_delta {
+      name                producer;
+      double              delta = 0;
+
+      uint64_t primary_key()const { return producer.value; }
+
+      // explicit serialization macro is not necessary, used here only to improve compilation time
+      EOSLIB_SERIALIZE( vote_delta, (producer)(delta) )
+   };
+
+   typedef eosio::multi_index< "votedeltas"_n, vote_delta > vote_deltas_table;
+
+   /**
+    * Producer stats.
+    *
+    * @details Per-block counters of a producer, kept apart from the much larger `producer_info` row so
+    * that `onblock` only rewrites a few bytes:
+    * - `owner` the producer,
+    * - `unpaid_blocks` blocks produced since the rewards snapshot of slot `unpaid_since`,
+    * - `lifetime_produced_blocks` blocks produced since the last rewards snapshot,
+    * - `unpaid_since` the slot of the rewards snapshot `unpaid_blocks` counts from.
+    *
+    * Every rewards snapshot folds both counters into `producer_info` and resets them, so clients reading
+    * `producer_info` see counters that are at most one snapshot old. The current values are the sum of
+    * both rows.
+    */
+   struct [[eosio::table, eosio::contract("eosio.system")]] producer_stats {
+      name                owner;
+      uint32_t            unpaid_blocks = 0;
+      uint32_t            lifetime_produced_blocks = 0;
+      uint32_t            unpaid_since = 0;
+
+      uint64_t primary_key()const { return owner.value; }
+
+      // explicit serialization macro is not necessary, used here only to improve compilation time
+      EOSLIB_SERIALIZE( producer_stats, (owner)(unpaid_blocks)(lifetime_produced_blocks)(unpaid_since) )
+   };
+
+   typedef eosio::multi_index< "prodstats"_n, producer_stats > producer_stats_table;
+
    /**
     * Global state singleton added in version 1.0
     */
-   typedef eosio::singleton< "global"_n, eosio_global_state >   global_state_singleton;
+   typedef tracked_singleton< "global"_n, eosio_global_state >   global_state_singleton;
 
    struct [[eosio::table, eosio::contract("eosio.system")]] user_resources {
       name          owner;
@@ -468,7 +698,7 @@ namespace eosiosystem {
       asset   vote_stake;
       asset   rex_balance;
       int64_t matured_rex = 0;
-      std::deque<std::pair<time_point_sec, int64_t>> rex_maturities; /// REX daily maturity buckets
+      std::vector<std::pair<time_point_sec, int64_t>> rex_maturities; /// REX daily maturity buckets
 
       uint64_t primary_key()const { return owner.value; }
    };
@@ -529,6 +759,61 @@ namespace eosiosystem {
                                indexed_by<"byowner"_n, const_mem_fun<rex_loan, uint64_t, &rex_loan::by_owner>>
                              > rex_net_loan_table;
 
+   /**
+    * `rex_loan_expiry` identifies a loan in a loan wheel bucket, buckets are sorted by expiration then loan number.
+    */
+   struct rex_loan_expiry {
+      eosio::time_point   expiration;
+      uint64_t            loan_num;
+
+      friend bool operator<( const rex_loan_expiry& a, const rex_loan_expiry& b ) {
+         return std::tie( a.expiration, a.loan_num ) < std::tie( b.expiration, b.loan_num );
+      }
+
+      EOSLIB_SERIALIZE( rex_loan_expiry, (expiration)(loan_num) )
+   };
+
+   /**
+    * `rex_loan_bucket` structure underlying the loan wheel table.
+    *
+    * @details A loan wheel entry lists the CPU and NET loans expiring in one hour:
+    * - `hour` the expiration hour, in hours since epoch,
+    * - `cpu_loans` the CPU loans expiring in that hour,
+    * - `net_loans` the NET loans expiring in that hour.
+    *
+    * `runrex` reads the due buckets in primary key order instead of the `byexpr` indexes of the loan tables.
+    */
+   struct [[eosio::table,eosio::contract("eosio.system")]] rex_loan_bucket {
+      uint32_t                      hour;
+      std::vector<rex_loan_expiry>  cpu_loans;
+      std::vector<rex_loan_expiry>  net_loans;
+
+      uint64_t primary_key()const { return hour; }
+
+      // explicit serialization macro is not necessary, used here only to improve compilation time
+      EOSLIB_SERIALIZE( rex_loan_bucket, (hour)(cpu_loans)(net_loans) )
+   };
+
+   typedef eosio::multi_index< "loanwheel"_n, rex_loan_bucket > rex_loan_wheel;
+
+   /**
+    * Loan wheel index state.
+    *
+    * @details Tracks the backfill of the loan wheel with loans created before it existed:
+    * - `complete` whether every loan is in the wheel, `runrex` reads the wheel from then on,
+    * - `net` whether CPU loans are done and NET loans are being indexed,
+    * - `cursor` the next loan number to be indexed.
+    */
+   struct [[eosio::table("loanidx"), eosio::contract("eosio.system")]] rex_loan_index_state {
+      bool                complete = false;
+      bool                net = false;
+      uint64_t            cursor = 0;
+
+      EOSLIB_SERIALIZE( rex_loan_index_state, (complete)(net)(cursor) )
+   };
+
+   typedef eosio::singleton< "loanidx"_n, rex_loan_index_state > rex_loan_index_singleton;
+
    struct [[eosio::table,eosio::contract("eosio.system")]] rex_order {
       uint8_t             version = 0;
       name                owner;
@@ -567,6 +852,8 @@ namespace eosiosystem {
       private:
          voters_table                _voters;
          producers_table             _producers;
+         vote_deltas_table           _vote_deltas;
+         producer_stats_table        _prodstats;
          global_state_singleton      _global;
          eosio_global_state          _gstate;
          rammarket                   _rammarket;
@@ -582,6 +869,10 @@ namespace eosiosystem {
          payrate_singleton           _payrate;
          payrates                    _gpayrate;
          payments_table              _payments;
+         vote_reconcile_singleton    _reconcile;
+         vote_reconcile_state        _greconcile;
+         delegators_index_singleton  _delegidx;
+         delegators_index_state      _gdelegidx;
 
       public:
          static constexpr eosio::name active_permission{"active"_n};
@@ -816,9 +1107,10 @@ namespace eosiosystem {
           *
           * @details Sells REX in exchange for core tokens by converting REX stake back into core tokens
           * at current exchange rate. If order cannot be processed, it gets queued until there is enough
-          * in REX pool to fill order, and will be processed within 30 days at most. If successful, user
-          * votes are updated, that is, proceeds are deducted from user's voting power. In case sell order
-          * is queued, storage change is billed to 'from' account.
+          * in REX pool to fill order, and will be processed within 30 days at most. A queued order is
+          * partially filled against the available unlent tokens, the remaining REX stays queued. If
+          * successful, user votes are updated, that is, proceeds are deducted from user's voting power.
+          * In case sell order is queued, storage change is billed to 'from' account.
           *
           * @param from - owner account of REX,
           * @param rex - amount of REX to be sold.
@@ -829,7 +1121,8 @@ namespace eosiosystem {
          /**
           * Cnclrexorder action.
           *
-          * @details Cancels unfilled REX sell order by owner if one exists.
+          * @details Cancels unfilled REX sell order by owner if one exists. Proceeds of a partially
+          * filled order are transferred to owner's REX fund, the remaining REX is no longer for sale.
           *
           * @param owner - owner account name.
           *
@@ -954,6 +1247,23 @@ namespace eosiosystem {
          [[eosio::action]]
          void rexexec( const name& user, uint16_t max );
 
+         /**
+          * Index loans action.
+          *
+          * @details Adds at most `max` CPU and NET loans created before the loan wheel existed to the wheel.
+          * New and renewed loans are added as they go, `runrex` switches from the `byexpr` indexes to the
+          * wheel once every existing loan has been indexed.
+          *
+          * Wheel buckets are billed to the system account, as for new loans. A loan is listed at most once
+          * and the backfill never restarts, so the RAM `user` can make the system account pay is bounded by
+          * the loans outstanding when the wheel was introduced.
+          *
+          * @param user - any account can execute this action,
+          * @param max - number of loans to be visited.
+          */
+         [[eosio::action]]
+         void indexloans( const name& user, uint16_t max );
+
          /**
           * Consolidate action.
           *
@@ -1172,6 +1482,22 @@ namespace eosiosystem {
          [[eosio::action]]
          void voteproducer( const name& voter, const name& proxy, const std::vector<name>& producers );
 
+         /**
+          * Vote batch action.
+          *
+          * @details Applies a list of votes as if each was a `voteproducer` action, in order. The producer
+          * vote changes of all entries are merged and every affected producer is updated once, so
+          * custodians and proxies can cast many votes per transaction.
+          *
+          * @param votes - the votes to apply.
+          *
+          * @pre `votes` is not empty
+          * @pre Every entry satisfies the preconditions of `voteproducer`
+          * @pre Every voter must authorize this action
+          */
+         [[eosio::action]]
+         void votebatch( const std::vector<vote_entry>& votes );
+
          /**
           * Register proxy action.
           *
@@ -1210,6 +1536,23 @@ namespace eosiosystem {
          [[eosio::action]]
          void claimrewards( const name& owner );
 
+         /**
+          * Check supply action.
+          *
+          * @details Compares the core token supply mirrored by the system contract with the supply
+          * recorded by eosio.token, and resets the mirror to the latter when they differ.
+          *
+          * @param user - any account can execute this action.
+          */
+         [[eosio::action]]
+         void checksupply( const name& user );
+
+         [[eosio::on_notify("eosio.token::issue")]]
+         void issue_handler( const name& to, const asset& quantity, const std::string& memo );
+
+         [[eosio::on_notify("eosio.token::retire")]]
+         void retire_handler( const asset& quantity, const std::string& memo );
+
          /**
           * Set privilege status for an account.
           *
@@ -1266,6 +1609,7 @@ namespace eosiosystem {
           * Bid refund action.
           *
           * @details Allows the account `bidder` to get back the amount it bid so far on a `newname` name.
+          * Only pays refunds recorded per name before outbid amounts were queued for `claimrefund`.
           *
           * @param bidder - the account that gets refunded,
           * @param newname - the name for which the bid was placed and now it gets refunded for.
@@ -1273,6 +1617,58 @@ namespace eosiosystem {
          [[eosio::action]]
          void bidrefund( const name& bidder, const name& newname );
 
+         /**
+          * Claim refund action.
+          *
+          * @details Pays the account `bidder` back the amounts it was outbid by on any name, as queued
+          * by `bidname`. Any account can send it, the refund only ever goes to `bidder`.
+          *
+          * @param bidder - the account that gets refunded.
+          */
+         [[eosio::action]]
+         void claimrefund( const name& bidder );
+
+         /**
+          * Reconcile votes action.
+          *
+          * @details Replays at most `max` voters of a vote reconciliation in progress. A reconciliation
+          * is started by `onblock` once `total_producer_vote_weight` drifts below zero, and is otherwise
+          * advanced by `reconcile_voters_per_block` voters per block.
+          *
+          * @param user - any account can execute this action,
+          * @param max - number of voters to be replayed.
+          */
+         [[eosio::action]]
+         void reconvotes( const name& user, uint16_t max );
+
+         /**
+          * Index proxied voters action.
+          *
+          * @details Backfills the delegators table with at most `max` voters that have set a proxy.
+          * Voters changing proxy are indexed as they go, this action only covers existing votes.
+          *
+          * @param user - any account can execute this action,
+          * @param max - number of voters to be visited.
+          */
+         [[eosio::action]]
+         void indexproxied( const name& user, uint16_t max );
+
+         /**
+          * Rebuild proxy action.
+          *
+          * @details Re-derives `proxied_vote_weight` of `proxy` from the stake of its delegators and
+          * propagates the corrected weight to the producers the proxy votes for. Every delegator of
+          * `proxy` is read in one action, so only the system account can run it.
+          *
+          * @param proxy - the proxy to rebuild.
+          *
+          * @pre The delegators table has been fully backfilled
+          * @pre No vote reconciliation is in progress
+          * @pre `proxy` is registered as a proxy
+          */
+         [[eosio::action]]
+         void rebuildproxy( const name& proxy );
+
          [[eosio::action]]
          void votebpout(name bp, uint32_t penalty_hours);
 
@@ -1301,6 +1697,7 @@ namespace eosiosystem {
          using defnetloan_action = eosio::action_wrapper<"defnetloan"_n, &system_contract::defnetloan>;
          using updaterex_action = eosio::action_wrapper<"updaterex"_n, &system_contract::updaterex>;
          using rexexec_action = eosio::action_wrapper<"rexexec"_n, &system_contract::rexexec>;
+         using indexloans_action = eosio::action_wrapper<"indexloans"_n, &system_contract::indexloans>;
          using setrex_action = eosio::action_wrapper<"setrex"_n, &system_contract::setrex>;
          using mvtosavings_action = eosio::action_wrapper<"mvtosavings"_n, &system_contract::mvtosavings>;
          using mvfrsavings_action = eosio::action_wrapper<"mvfrsavings"_n, &system_contract::mvfrsavings>;
@@ -1316,12 +1713,18 @@ namespace eosiosystem {
          using setram_action = eosio::action_wrapper<"setram"_n, &system_contract::setram>;
          using setramrate_action = eosio::action_wrapper<"setramrate"_n, &system_contract::setramrate>;
          using voteproducer_action = eosio::action_wrapper<"voteproducer"_n, &system_contract::voteproducer>;
+         using votebatch_action = eosio::action_wrapper<"votebatch"_n, &system_contract::votebatch>;
          using regproxy_action = eosio::action_wrapper<"regproxy"_n, &system_contract::regproxy>;
+         using reconvotes_action = eosio::action_wrapper<"reconvotes"_n, &system_contract::reconvotes>;
+         using indexproxied_action = eosio::action_wrapper<"indexproxied"_n, &system_contract::indexproxied>;
+         using rebuildproxy_action = eosio::action_wrapper<"rebuildproxy"_n, &system_contract::rebuildproxy>;
          using claimrewards_action = eosio::action_wrapper<"claimrewards"_n, &system_contract::claimrewards>;
+         using checksupply_action = eosio::action_wrapper<"checksupply"_n, &system_contract::checksupply>;
          using rmvproducer_action = eosio::action_wrapper<"rmvproducer"_n, &system_contract::rmvproducer>;
          using updtrevision_action = eosio::action_wrapper<"updtrevision"_n, &system_contract::updtrevision>;
          using bidname_action = eosio::action_wrapper<"bidname"_n, &system_contract::bidname>;
          using bidrefund_action = eosio::action_wrapper<"bidrefund"_n, &system_contract::bidrefund>;
+         using claimrefund_action = eosio::action_wrapper<"claimrefund"_n, &system_contract::claimrefund>;
          using setpriv_action = eosio::action_wrapper<"setpriv"_n, &system_contract::setpriv>;
          using setalimits_action = eosio::action_wrapper<"setalimits"_n, &system_contract::setalimits>;
          using setparams_action = eosio::action_wrapper<"setparams"_n, &system_contract::setparams>;
@@ -1346,6 +1749,8 @@ namespace eosiosystem {
          void check_voting_requirement( const name& owner,
                                         const char* error_msg = "must vote for at least 21 producers or for a proxy before buying REX" )const;
          rex_order_outcome fill_rex_order( const rex_balance_table::const_iterator& bitr, const asset& rex );
+         rex_order_outcome fill_rex_order( rex_pool& pool, const rex_balance_table::const_iterator& bitr, const asset& rex );
+         int64_t get_fillable_rex( const rex_pool& pool )const;
          asset update_rex_account( const name& owner, const asset& proceeds, const asset& unstake_quant, bool force_vote_update = false );
          void channel_to_rex( const name& from, const asset& amount );
          void channel_namebid_to_rex( const int64_t highest_bid );
@@ -1364,14 +1769,17 @@ namespace eosiosystem {
          asset add_to_rex_balance( const name& owner, const asset& payment, const asset& rex_received );
          asset add_to_rex_pool( const asset& payment );
          void process_rex_maturities( const rex_balance_table::const_iterator& bitr );
+         void process_rex_maturities( rex_balance& rb );
          void consolidate_rex_balance( const rex_balance_table::const_iterator& bitr,
                                        const asset& rex_in_sell_order );
-         int64_t read_rex_savings( const rex_balance_table::const_iterator& bitr );
-         void put_rex_savings( const rex_balance_table::const_iterator& bitr, int64_t rex );
+         int64_t read_rex_savings( rex_balance& rb );
+         void put_rex_savings( rex_balance& rb, int64_t rex );
          void update_rex_stake( const name& voter );
 
-         void add_loan_to_rex_pool( const asset& payment, int64_t rented_tokens, bool new_loan );
-         void remove_loan_from_rex_pool( const rex_loan& loan );
+         void add_loan_to_rex_pool( rex_pool& pool, const asset& payment, int64_t rented_tokens, bool new_loan );
+         void remove_loan_from_rex_pool( rex_pool& pool, const rex_loan& loan );
+         void add_loan_to_wheel( bool cpu, const rex_loan& loan );
+         void remove_loan_from_wheel( bool cpu, const rex_loan& loan );
          template <typename Index, typename Iterator>
          int64_t update_renewed_loan( Index& idx, const Iterator& itr, int64_t rented_tokens );
 
@@ -1380,16 +1788,28 @@ namespace eosiosystem {
                         const asset& stake_net_quantity, const asset& stake_cpu_quantity, bool transfer );
          void update_voting_power( const name& voter, const asset& total_update );
 
+         // defined in name_bidding.cpp
+         name_bid top_name_bid();
+         void refresh_top_name_bid();
+
          // defined in producer_pay.cpp
          void claimrewards_snapshot();
+         void settle_reward( const name& owner, uint8_t shares, int64_t pay_per_share );
 
          // defined in voting.cpp
          void update_elected_producers( const block_timestamp& timestamp );
          void update_votes( const name& voter, const name& proxy, const std::vector<name>& producers, bool voting );
+         void update_votes( const name& voter, const name& proxy, const std::vector<name>& producers, bool voting,
+                            producer_deltas_map& producer_deltas );
+         void apply_producer_deltas( const producer_deltas_map& producer_deltas, bool voting );
+         void settle_vote_deltas();
          void propagate_weight_change( const voter_info& voter );
+         void propagate_weight_change( const voter_info& voter, producer_deltas_map& producer_deltas );
 
          double inverse_vote_weight(double staked, double amountVotedProducers);
-         void recalculate_votes();
+         void reconcile_votes( uint16_t max );
+         void refresh_stale_voter( const voters_table::const_iterator& voter );
+         void index_delegator( const name& voter, const name& old_proxy, const name& new_proxy, const name& payer );
 
          //defined in system_kick.cpp
          bool crossed_missed_blocks_threshold(uint32_t amountBlocksMissed, uint32_t schedule_size);
@@ -1397,15 +1817,17 @@ namespace eosiosystem {
          void update_producer_missed_blocks(name producer);
          bool is_new_schedule_activated(capi_name active_schedule[], uint32_t size);
          bool is_new_schedule_activated(std::vector<name>& schedule);
-         bool check_missed_blocks(block_timestamp timestamp, name producer);
+         bool is_proposed_schedule_active(uint32_t active_schedule_version);
+         bool check_missed_blocks(block_timestamp timestamp, name producer, uint32_t active_schedule_version);
 
          //define in system_rotation.cpp
          void set_bps_rotation(name bpOut, name sbpIn);
          void update_rotation_time(block_timestamp block_time);
          void update_missed_blocks_per_rotation();
-         void restart_missed_blocks_per_rotation(std::vector<eosio::producer_key> prods);
+         void restart_missed_blocks_per_rotation(const std::vector<eosio::producer_key>& prods);
          bool is_in_range(int32_t index, int32_t low_bound, int32_t up_bound);
-         std::vector<eosio::producer_key> check_rotation_state(std::vector<eosio::producer_key> producers, block_timestamp block_time);
+         uint32_t find_rotated_producer(const std::vector<eosio::producer_key>& prods, name producer, uint32_t index);
+         void check_rotation_state(std::vector<eosio::producer_key>& producers, block_timestamp block_time);
 
          template <auto system_contract::*...Ptrs>
          class registration {
@@ -13,12 +13,16 @@ namespace eosiosystem {
    :native(s,code,ds),
     _voters(_self, _self.value),
     _producers(_self, _self.value),
+    _vote_deltas(_self, _self.value),
+    _prodstats(_self, _self.value),
     _global(_self, _self.value),
     _rammarket(_self, _self.value),
     _schedule_metrics(_self, _self.value),
     _rotation(_self, _self.value),
     _payrate(_self, _self.value),
     _payments(_self, _self.value),
+    _reconcile(_self, _self.value),
+    _delegidx(_self, _self.value),
 	_rexpool(_self, _self.value),
     _rexfunds(_self, _self.value),
     _rexbalance(_self, _self.value),
@@ -30,6 +34,8 @@ namespace eosiosystem {
       _gschedule_metrics = _schedule_metrics.get_or_create(_self, schedule_metrics_state{ name(0), 0, std::vector<producer_metric>() });
       _grotation = _rotation.get_or_create(_self, rotation_state{ name(0), name(0), 21, 75, block_timestamp(), block_timestamp() });
       _gpayrate = _payrate.get_or_create(_self, payrates{ max_bpay_rate, max_worker_monthly_amount });
+      _greconcile = _reconcile.get_or_create(_self, vote_reconcile_state{});
+      _gdelegidx = _delegidx.get_or_create(_self, delegators_index_state{});
    }
 
    eosio_global_state system_contract::get_default_parameters() {
@@ -48,6 +54,8 @@ namespace eosiosystem {
       _schedule_metrics.set(_gschedule_metrics, _self);
       _rotation.set(_grotation, _self);
       _payrate.set(_gpayrate, _self);
+      _reconcile.set(_greconcile, _self);
+      _delegidx.set(_gdelegidx, _self);
    }
 
    void system_contract::setram( uint64_t max_ram_size ) {
@@ -1,8 +1,6 @@
 #include <eosio.system/eosio.system.hpp>
 #include <eosio.token/eosio.token.hpp>
 
-#include <eosio/transaction.hpp>
-
 namespace eosiosystem {
 
    using eosio::current_time_point;
@@ -35,36 +33,38 @@ namespace eosiosystem {
          check( bid.amount - current->high_bid > (current->high_bid / 10), "must increase bid by 10%" );
          check( current->high_bidder != bidder, "account is already highest bidder" );
 
-         bid_refund_table refunds_table(get_self(), newname.value);
+         // the outbid amount is queued until it is claimed, no deferred transaction is needed
+         bid_refund_queue refunds(get_self(), get_self().value);
 
-         auto it = refunds_table.find( current->high_bidder.value );
-         if ( it != refunds_table.end() ) {
-            refunds_table.modify( it, same_payer, [&](auto& r) {
+         auto it = refunds.find( current->high_bidder.value );
+         if ( it != refunds.end() ) {
+            refunds.modify( it, same_payer, [&](auto& r) {
                   r.amount += asset( current->high_bid, core_symbol() );
                });
          } else {
-            refunds_table.emplace( bidder, [&](auto& r) {
+            refunds.emplace( get_self(), [&](auto& r) {
                   r.bidder = current->high_bidder;
                   r.amount = asset( current->high_bid, core_symbol() );
                });
          }
 
-         eosio::transaction t;
-         t.actions.emplace_back( permission_level{get_self(), active_permission},
-                                 get_self(), "bidrefund"_n,
-                                 std::make_tuple( current->high_bidder, newname )
-         );
-         t.delay_sec = 0;
-         uint128_t deferred_id = (uint128_t(newname.value) << 64) | current->high_bidder.value;
-         eosio::cancel_deferred( deferred_id );
-         t.send( deferred_id, bidder );
-
          bids.modify( current, bidder, [&]( auto& b ) {
             b.high_bidder = bidder;
             b.high_bid = bid.amount;
             b.last_bid_time = current_time_point();
          });
       }
+
+      // bids only increase, so the top bid changes only when this bid reaches it
+      if( !_gstate.top_name_bid.has_value() ) {
+         refresh_top_name_bid();
+      } else {
+         const auto& top = _gstate.top_name_bid.value();
+         if( newname == top.newname || bid.amount > top.high_bid ||
+             (bid.amount == top.high_bid && newname.value < top.newname.value) ) {
+            _gstate.top_name_bid.emplace( bids.get( newname.value ) );
+         }
+      }
    }
 
    void system_contract::bidrefund( const name& bidder, const name& newname ) {
@@ -77,4 +77,33 @@ namespace eosiosystem {
       refunds_table.erase( it );
    }
 
+   void system_contract::claimrefund( const name& bidder ) {
+      bid_refund_queue refunds(get_self(), get_self().value);
+      auto it = refunds.find( bidder.value );
+      check( it != refunds.end(), "refund not found" );
+
+      token::transfer_action transfer_act{ token_account, { {names_account, active_permission} } };
+      transfer_act.send( names_account, bidder, it->amount, std::string("refund of outbid name bids") );
+      refunds.erase( it );
+   }
+
+   name_bid system_contract::top_name_bid() {
+      if( !_gstate.top_name_bid.has_value() ) {
+         refresh_top_name_bid();
+      }
+      return _gstate.top_name_bid.value();
+   }
+
+   /**
+    * Reads the highest open bid from the highbid index. The index is keyed on the negated bid, so the
+    * negative bids of closed auctions give small keys and sort first, and the lower bound at half the
+    * key range skips them to the highest open bid.
+    */
+   void system_contract::refresh_top_name_bid() {
+      name_bid_table bids(get_self(), get_self().value);
+      auto idx = bids.get_index<"highbid"_n>();
+      auto highest = idx.lower_bound( std::numeric_limits<uint64_t>::max()/2 );
+      _gstate.top_name_bid.emplace( highest != idx.end() && highest->high_bid > 0 ? *highest : name_bid{} );
+   }
+
 }
@@ -22,7 +22,10 @@ namespace eosiosystem {
 
         block_timestamp timestamp;
         name producer;
-        _ds >> timestamp >> producer;
+        uint16_t confirmed;
+        checksum256 previous, transaction_mroot, action_mroot;
+        uint32_t schedule_version;
+        _ds >> timestamp >> producer >> confirmed >> previous >> transaction_mroot >> action_mroot >> schedule_version;
 
         _gstate.block_num++;
         if (_gstate.thresh_activated_stake_time == time_point()) {
@@ -35,7 +38,7 @@ namespace eosiosystem {
      
         if (_gstate.last_pervote_bucket_fill == time_point()) _gstate.last_pervote_bucket_fill = current_time_point();
 
-        if(check_missed_blocks(timestamp, producer)) {
+        if(check_missed_blocks(timestamp, producer, schedule_version)) {
             update_missed_blocks_per_rotation();
             reset_schedule_metrics(producer);
         }
@@ -44,42 +47,55 @@ namespace eosiosystem {
          * At startup the initial producer may not be one that is registered / elected
          * and therefore there may be no producer object for them.
          */
-        auto prod = _producers.find( producer.value );
-        if ( prod != _producers.end() ) {
+        auto stats = _prodstats.find( producer.value );
+        if ( stats != _prodstats.end() ) {
             _gstate.total_unpaid_blocks++;
-            _producers.modify( prod, same_payer, [&](auto& p ) {
-                p.unpaid_blocks++;
-                p.lifetime_produced_blocks++;
+            _prodstats.modify( stats, same_payer, [&](auto& s ) {
+                if ( s.unpaid_since != _gstate.last_claimrewards ) { // first block since the last snapshot
+                    s.unpaid_blocks = 0;
+                    s.unpaid_since = _gstate.last_claimrewards;
+                }
+                s.unpaid_blocks++;
+                s.lifetime_produced_blocks++;
+            });
+        } else if ( _producers.find( producer.value ) != _producers.end() ) {
+            _gstate.total_unpaid_blocks++;
+            _prodstats.emplace( get_self(), [&](auto& s ) {
+                s.owner = producer;
+                s.unpaid_blocks = 1;
+                s.lifetime_produced_blocks = 1;
+                s.unpaid_since = _gstate.last_claimrewards;
             });
         }
 
-        recalculate_votes();
+        reconcile_votes( reconcile_voters_per_block );
 
         /// only update block producers once every minute, block_timestamp is in half seconds
         if( timestamp.slot - _gstate.last_producer_schedule_update.slot > 120 ) {
+            settle_vote_deltas();
             update_elected_producers( timestamp );
 
             if( (timestamp.slot - _gstate.last_name_close.slot) > blocks_per_day ) {
-                name_bid_table bids(_self, _self.value);
-                auto idx = bids.get_index<"highbid"_n>();
-                auto highest = idx.lower_bound( std::numeric_limits<uint64_t>::max()/2 );
-                if( highest != idx.end() &&
-                    highest->high_bid > 0 &&
-                    (current_time_point() - highest->last_bid_time) > microseconds(useconds_per_day) &&
+                const auto highest = top_name_bid();
+                if( highest.high_bid > 0 &&
+                    (current_time_point() - highest.last_bid_time) > microseconds(useconds_per_day) &&
                     _gstate.thresh_activated_stake_time > time_point() &&
                     (current_time_point() - _gstate.thresh_activated_stake_time) > microseconds(14 * useconds_per_day)
                 ) {
                 _gstate.last_name_close = timestamp;
-                channel_namebid_to_rex( highest->high_bid );
-                idx.modify( highest, same_payer, [&]( auto& b ){
+                channel_namebid_to_rex( highest.high_bid );
+                name_bid_table bids(_self, _self.value);
+                bids.modify( bids.get( highest.newname.value ), same_payer, [&]( auto& b ){
                     b.high_bid = -b.high_bid;
                 });
+                refresh_top_name_bid();
                 }
             }
         }
 
         //called once per day to set payments snapshot
         if (_gstate.last_claimrewards + uint32_t(3600) <= timestamp.slot) { //172800 blocks in a day
+            settle_vote_deltas();
             claimrewards_snapshot();
             _gstate.last_claimrewards = timestamp.slot;
         }
@@ -93,18 +109,39 @@ namespace eosiosystem {
         const auto& prod = _producers.get( owner.value );
         check( prod.active(), "producer does not have an active key" );
 
-        auto p = _payments.find(owner.value);
-        check(p != _payments.end(), "No payment exists for account");
-        auto prod_payment = *p;
-        auto pay_amount = prod_payment.pay;
+        int64_t pay_amount = 0;
 
-        //NOTE: consider resetting producer's last claim time to 0 here, instead of during snapshot.
-        {
-            token::transfer_action transfer_act{ token_account, { bpay_account, active_permission } };
-            transfer_act.send( bpay_account, owner, pay_amount, "Producer/Standby Payment" );
+        //payments credited before the reward index was introduced
+        auto payment = _payments.find(owner.value);
+        if (payment != _payments.end()) {
+            pay_amount += payment->pay.amount;
+            _payments.erase(payment);
+        }
+
+        reward_index_singleton reward_index(get_self(), get_self().value);
+        const auto index = reward_index.exists() ? reward_index.get() : reward_index_state{};
+
+        producer_rewards_table rewards(get_self(), get_self().value);
+        auto reward = rewards.find(owner.value);
+        if (reward != rewards.end()) {
+            pay_amount += reward->unclaimed + reward->shares * (index.pay_per_share - reward->pay_index);
+        }
+        check(pay_amount > 0, "No payment exists for account");
+
+        if (reward != rewards.end()) {
+            rewards.modify(reward, same_payer, [&](auto &r) {
+                r.pay_index = index.pay_per_share;
+                r.unclaimed = 0;
+            });
         }
 
-        _payments.erase(p);
+        _producers.modify(prod, same_payer, [&](auto &p) {
+            p.last_claim_time = index.last_snapshot;
+            p.unpaid_blocks = 0;
+        });
+
+        token::transfer_action transfer_act{ token_account, { bpay_account, active_permission } };
+        transfer_act.send( bpay_account, owner, asset(pay_amount, core_symbol()), "Producer/Standby Payment" );
    }
 
    void system_contract::claimrewards_snapshot() {
@@ -117,7 +154,11 @@ namespace eosiosystem {
 
         auto ct = current_time_point();
 
-        const asset token_supply = eosio::token::get_supply(token_account, core_symbol().code() );
+        token_mirror_singleton mirror(get_self(), get_self().value);
+        if (!mirror.exists()) {
+            mirror.set(token_mirror_state{ eosio::token::get_supply(token_account, core_symbol().code()) }, get_self());
+        }
+        const asset token_supply = mirror.get().supply;
         const auto usecs_since_last_fill = (ct - _gstate.last_pervote_bucket_fill).count();
         
         if (usecs_since_last_fill > 0 && _gstate.last_pervote_bucket_fill > time_point())
@@ -128,7 +169,8 @@ namespace eosiosystem {
             auto new_tokens = to_workers + to_producers;
 
             //NOTE: This line can cause failure if eosio.tedp doesn't have a balance emplacement
-            asset tedp_balance = eosio::token::get_balance(token_account, tedp_account, core_symbol().code());
+            //the balance is read from eosio.token, deposits to the TEDP account are not notified to this contract
+            asset tedp_balance = new_tokens > 0 ? eosio::token::get_balance(token_account, tedp_account, core_symbol().code()) : asset(0, core_symbol());
             
             int64_t transfer_tokens = 0;
             int64_t issue_tokens = 0;
@@ -148,19 +190,24 @@ namespace eosiosystem {
                 transfer_act.send( tedp_account, get_self(), asset(transfer_tokens, core_symbol()), "TEDP: Inflation offset" );
             }
 
-            token::transfer_action transfer_act{ token_account, { get_self(), active_permission } };  
-
             if (issue_tokens > 0) {
                 token::issue_action issue_action{ token_account, { get_self(), active_permission }};
                 issue_action.send(get_self(), asset(issue_tokens, core_symbol()), "Issue new TLOS tokens");
             }
             
+            //the worker and producer shares are paid by eosio, the token issuer, in one bulktransfer
+            std::vector<token_transfer> distribution;
             if(to_workers > 0) {
-                transfer_act.send(get_self(), saving_account, asset(to_workers, core_symbol()), "Transfer worker proposal share to eosio.saving account");
+                distribution.push_back(token_transfer{ saving_account, asset(to_workers, core_symbol()), "Transfer worker proposal share to eosio.saving account" });
             }
             
             if(to_producers > 0) {
-                transfer_act.send(get_self(), bpay_account, asset(to_producers, core_symbol()), "Transfer producer share to per-block bucket");
+                distribution.push_back(token_transfer{ bpay_account, asset(to_producers, core_symbol()), "Transfer producer share to per-block bucket" });
+            }
+
+            if (!distribution.empty()) {
+                token::bulktransfer_action bulktransfer_act{ token_account, { get_self(), active_permission } };
+                bulktransfer_act.send( get_self(), distribution );
             }
             
             _gstate.perblock_bucket += to_producers;
@@ -169,59 +216,130 @@ namespace eosiosystem {
 
         //sort producers table
         auto sortedprods = _producers.get_index<"prototalvote"_n>();
-        
+
+        //the paid producers in rank order, only the top 51 active producers are paid
+        std::vector<name> shareholders;
+        for (const auto &prod : sortedprods) {
+            if (!prod.active()) //skip inactive producers
+                continue;
+
+            shareholders.push_back(prod.owner);
+            if (shareholders.size() == 51)
+                break;
+        }
+
         uint32_t sharecount = 0;
 
         //calculate shares, should be between 2 and 72 shares
-        for (const auto &prod : sortedprods)
-        {
-            if (prod.active()) { 			//only count activated producers
-                if (sharecount <= 42) {
-                    sharecount += 2; 		//top producers count as double shares
-                } else if (sharecount >= 43 && sharecount < 72) {
-                    sharecount++;
-                } else
-                    break; 					//no need to count past 72 shares
-            }
+        for (size_t i = 0; i < shareholders.size(); ++i) {
+            if (sharecount <= 42) {
+                sharecount += 2; 		//top producers count as double shares
+            } else if (sharecount >= 43 && sharecount < 72) {
+                sharecount++;
+            } else
+                break; 					//no need to count past 72 shares
         }
-        
+
         auto shareValue = (_gstate.perblock_bucket / sharecount);
-        int32_t index = 0;
 
-        for (const auto &prod : sortedprods) {
+        //producers hold two shares in the top 21 and one share below, only the producers
+        //whose share count changes since the last snapshot are settled at the current index
+        reward_index_singleton reward_index(get_self(), get_self().value);
+        auto index = reward_index.exists() ? reward_index.get() : reward_index_state{};
 
-            if (!prod.active()) //skip inactive producers
+        boost::container::flat_map<name, std::pair<uint8_t, uint8_t>> share_changes; // old and new shares
+        for (size_t i = 0; i < index.shareholders.size(); ++i) {
+            share_changes[index.shareholders[i]].first = i < 21 ? 2 : 1;
+        }
+        uint32_t total_shares = 0;
+        for (size_t i = 0; i < shareholders.size(); ++i) {
+            const uint8_t shares = i < 21 ? 2 : 1;
+            share_changes[shareholders[i]].second = shares;
+            total_shares += shares;
+        }
+        for (const auto &change : share_changes) {
+            if (change.second.first != change.second.second) {
+                settle_reward(change.first, change.second.second, index.pay_per_share);
+            }
+        }
+
+        index.pay_per_share += shareValue;
+        index.last_snapshot = ct;
+        index.shareholders = std::move(shareholders);
+        reward_index.set(index, get_self());
+
+        _gstate.perblock_bucket -= shareValue * int64_t(total_shares);
+        _gstate.total_unpaid_blocks = 0;
+
+        //fold the block counters of the closed window into producer_info, where existing clients read them
+        for (auto stats = _prodstats.begin(); stats != _prodstats.end(); ++stats) {
+            if (stats->lifetime_produced_blocks == 0) //no blocks since the last snapshot
                 continue;
 
-            int64_t pay_amount = 0;
-            index++;
-            
-            if (index <= 21) {
-                pay_amount = (shareValue * int64_t(2));
-            } else if (index >= 22 && index <= 51) {
-                pay_amount = shareValue;
-            } else 
-                break;
-            
-            _gstate.perblock_bucket -= pay_amount;
-            _gstate.total_unpaid_blocks -= prod.unpaid_blocks;
+            const uint32_t unpaid = stats->unpaid_since == _gstate.last_claimrewards ? stats->unpaid_blocks : 0;
+            _producers.modify(_producers.get(stats->owner.value), same_payer, [&](auto &p) {
+                p.unpaid_blocks += unpaid;
+                p.lifetime_produced_blocks += stats->lifetime_produced_blocks;
+            });
+            _prodstats.modify(stats, same_payer, [&](auto &s) {
+                s.unpaid_blocks = 0;
+                s.lifetime_produced_blocks = 0;
+            });
+        }
+    }
 
-            _producers.modify(prod, same_payer, [&](auto &p) {
-                p.last_claim_time = ct;
-                p.unpaid_blocks = 0;
+    void system_contract::settle_reward( const name& owner, uint8_t shares, int64_t pay_per_share ) {
+        producer_rewards_table rewards(get_self(), get_self().value);
+        auto reward = rewards.find(owner.value);
+
+        if (reward == rewards.end()) {
+            rewards.emplace(get_self(), [&](auto &r) {
+                r.owner = owner;
+                r.shares = shares;
+                r.pay_index = pay_per_share;
+            });
+        } else {
+            rewards.modify(reward, same_payer, [&](auto &r) {
+                r.unclaimed += r.shares * (pay_per_share - r.pay_index);
+                r.pay_index = pay_per_share;
+                r.shares = shares;
             });
+        }
+    }
 
-            auto itr = _payments.find(prod.owner.value);
-            
-            if (itr == _payments.end()) {
-                _payments.emplace(_self, [&]( auto& a ) { 
-                    a.bp = prod.owner;
-                    a.pay = asset(pay_amount, core_symbol());
-                });
-            } else //adds new payment to existing payment
-                _payments.modify(itr, same_payer, [&]( auto& a ) {
-                    a.pay += asset(pay_amount, core_symbol());
-                });
+    void system_contract::checksupply( const name& user ) {
+        require_auth(user);
+
+        const asset supply = eosio::token::get_supply(token_account, core_symbol().code());
+        token_mirror_singleton mirror(get_self(), get_self().value);
+        //the mirror is only written when it is missing or has drifted
+        if (!mirror.exists() || mirror.get().supply != supply) {
+            mirror.set(token_mirror_state{ supply }, get_self());
+        }
+    }
+
+    void system_contract::issue_handler( const name& to, const asset& quantity, const std::string& memo ) {
+        //supply changes before the mirror is seeded are part of the supply it is seeded with
+        token_mirror_singleton mirror(get_self(), get_self().value);
+        if (!mirror.exists()) {
+            return;
+        }
+        token_mirror_state mirrored = mirror.get();
+        if (quantity.symbol == mirrored.supply.symbol) {
+            mirrored.supply += quantity;
+            mirror.set(mirrored, get_self());
+        }
+    }
+
+    void system_contract::retire_handler( const asset& quantity, const std::string& memo ) {
+        token_mirror_singleton mirror(get_self(), get_self().value);
+        if (!mirror.exists()) {
+            return;
+        }
+        token_mirror_state mirrored = mirror.get();
+        if (quantity.symbol == mirrored.supply.symbol) {
+            mirrored.supply -= quantity;
+            mirror.set(mirrored, get_self());
         }
     }
 
@@ -149,6 +149,8 @@ namespace eosiosystem {
 
       auto itr = _rexorders.require_find( owner.value, "no sellrex order is scheduled" );
       check( itr->is_open, "sellrex order has been filled and cannot be canceled" );
+      /// settle the part of the order that has already been filled
+      update_rex_account( owner, asset( 0, core_symbol() ), asset( 0, core_symbol() ) );
       _rexorders.erase( itr );
    }
 
@@ -222,10 +224,10 @@ namespace eosiosystem {
       }
       _rexbalance.modify( itr, same_payer, [&]( auto& rb ) {
          rb.vote_stake = current_stake;
+         process_rex_maturities( rb );
       });
 
       update_rex_account( owner, asset( 0, core_symbol() ), current_stake - init_stake, true );
-      process_rex_maturities( itr );
    }
 
    void system_contract::setrex( const asset& balance )
@@ -247,6 +249,39 @@ namespace eosiosystem {
       runrex( max );
    }
 
+   void system_contract::indexloans( const name& user, uint16_t max )
+   {
+      require_auth( user );
+      check( max > 0, "must index at least one loan" );
+
+      rex_loan_index_singleton loanidx( get_self(), get_self().value );
+      auto state = loanidx.get_or_default();
+      check( !state.complete, "loans are already indexed" );
+
+      auto index_table = [&]( bool cpu, auto& loans ) {
+         auto itr = loans.lower_bound( state.cursor );
+         for ( ; itr != loans.end() && max > 0; ++itr, --max ) {
+            add_loan_to_wheel( cpu, *itr );
+         }
+         if ( itr == loans.end() ) {
+            state.cursor = 0;
+            return true;
+         }
+         state.cursor = itr->loan_num;
+         return false;
+      };
+
+      if ( !state.net ) {
+         rex_cpu_loan_table cpu_loans( get_self(), get_self().value );
+         state.net = index_table( true, cpu_loans );
+      }
+      if ( state.net && max > 0 ) {
+         rex_net_loan_table net_loans( get_self(), get_self().value );
+         state.complete = index_table( false, net_loans );
+      }
+      loanidx.set( state, get_self() );
+   }
+
    void system_contract::consolidate( const name& owner )
    {
       require_auth( owner );
@@ -267,11 +302,11 @@ namespace eosiosystem {
       auto bitr = _rexbalance.require_find( owner.value, "account has no REX balance" );
       check( rex.amount > 0 && rex.symbol == bitr->rex_balance.symbol, "asset must be a positive amount of (REX, 4)" );
       const asset   rex_in_sell_order = update_rex_account( owner, asset( 0, core_symbol() ), asset( 0, core_symbol() ) );
-      const int64_t rex_in_savings    = read_rex_savings( bitr );
-      check( rex.amount + rex_in_sell_order.amount + rex_in_savings <= bitr->rex_balance.amount,
-             "insufficient REX balance" );
-      process_rex_maturities( bitr );
       _rexbalance.modify( bitr, same_payer, [&]( auto& rb ) {
+         const int64_t rex_in_savings = read_rex_savings( rb );
+         check( rex.amount + rex_in_sell_order.amount + rex_in_savings <= rb.rex_balance.amount,
+                "insufficient REX balance" );
+         process_rex_maturities( rb );
          int64_t moved_rex = 0;
          while ( !rb.rex_maturities.empty() && moved_rex < rex.amount) {
             const int64_t drex = std::min( rex.amount - moved_rex, rb.rex_maturities.back().second );
@@ -288,8 +323,8 @@ namespace eosiosystem {
             check( rex_in_sell_order.amount <= rb.matured_rex, "logic error in mvtosavings" );
          }
          check( moved_rex == rex.amount, "programmer error in mvtosavings" );
+         put_rex_savings( rb, rex_in_savings + rex.amount );
       });
-      put_rex_savings( bitr, rex_in_savings + rex.amount );
    }
 
    void system_contract::mvfrsavings( const name& owner, const asset& rex )
@@ -300,18 +335,18 @@ namespace eosiosystem {
 
       auto bitr = _rexbalance.require_find( owner.value, "account has no REX balance" );
       check( rex.amount > 0 && rex.symbol == bitr->rex_balance.symbol, "asset must be a positive amount of (REX, 4)" );
-      const int64_t rex_in_savings = read_rex_savings( bitr );
-      check( rex.amount <= rex_in_savings, "insufficient REX in savings" );
-      process_rex_maturities( bitr );
       _rexbalance.modify( bitr, same_payer, [&]( auto& rb ) {
+         const int64_t rex_in_savings = read_rex_savings( rb );
+         check( rex.amount <= rex_in_savings, "insufficient REX in savings" );
+         process_rex_maturities( rb );
          const time_point_sec maturity = get_rex_maturity();
          if ( !rb.rex_maturities.empty() && rb.rex_maturities.back().first == maturity ) {
             rb.rex_maturities.back().second += rex.amount;
          } else {
             rb.rex_maturities.emplace_back( maturity, rex.amount );
          }
+         put_rex_savings( rb, rex_in_savings - rex.amount );
       });
-      put_rex_savings( bitr, rex_in_savings - rex.amount );
       update_rex_account( owner, asset( 0, core_symbol() ), asset( 0, core_symbol() ) );
    }
 
@@ -446,47 +481,113 @@ namespace eosiosystem {
    /**
     * @brief Updates rex_pool balances upon creating a new loan or renewing an existing one
     *
+    * @param pool - rex_pool balances to be updated, stored by the caller
     * @param payment - loan fee paid
     * @param rented_tokens - amount of tokens to be staked to loan receiver
     * @param new_loan - flag indicating whether the loan is new or being renewed
     */
-   void system_contract::add_loan_to_rex_pool( const asset& payment, int64_t rented_tokens, bool new_loan )
+   void system_contract::add_loan_to_rex_pool( rex_pool& pool, const asset& payment, int64_t rented_tokens, bool new_loan )
    {
-      _rexpool.modify( _rexpool.begin(), same_payer, [&]( auto& rt ) {
-         // add payment to total_rent
-         rt.total_rent.amount    += payment.amount;
-         // move rented_tokens from total_unlent to total_lent
-         rt.total_unlent.amount  -= rented_tokens;
-         rt.total_lent.amount    += rented_tokens;
-         // add payment to total_unlent
-         rt.total_unlent.amount  += payment.amount;
-         rt.total_lendable.amount = rt.total_unlent.amount + rt.total_lent.amount;
-         // increment loan_num if a new loan is being created
-         if ( new_loan ) {
-            rt.loan_num++;
-         }
-      });
+      // add payment to total_rent
+      pool.total_rent.amount    += payment.amount;
+      // move rented_tokens from total_unlent to total_lent
+      pool.total_unlent.amount  -= rented_tokens;
+      pool.total_lent.amount    += rented_tokens;
+      // add payment to total_unlent
+      pool.total_unlent.amount  += payment.amount;
+      pool.total_lendable.amount = pool.total_unlent.amount + pool.total_lent.amount;
+      // increment loan_num if a new loan is being created
+      if ( new_loan ) {
+         pool.loan_num++;
+      }
    }
 
    /**
     * @brief Updates rex_pool balances upon closing an expired loan
     *
+    * @param pool - rex_pool balances to be updated, stored by the caller
     * @param loan - loan to be closed
     */
-   void system_contract::remove_loan_from_rex_pool( const rex_loan& loan )
+   void system_contract::remove_loan_from_rex_pool( rex_pool& pool, const rex_loan& loan )
    {
-      const auto& pool = _rexpool.begin();
-      const int64_t delta_total_rent = exchange_state::get_bancor_output( pool->total_unlent.amount,
-                                                                          pool->total_rent.amount,
+      const int64_t delta_total_rent = exchange_state::get_bancor_output( pool.total_unlent.amount,
+                                                                          pool.total_rent.amount,
                                                                           loan.total_staked.amount );
-      _rexpool.modify( pool, same_payer, [&]( auto& rt ) {
-         // deduct calculated delta_total_rent from total_rent
-         rt.total_rent.amount    -= delta_total_rent;
-         // move rented tokens from total_lent to total_unlent
-         rt.total_unlent.amount  += loan.total_staked.amount;
-         rt.total_lent.amount    -= loan.total_staked.amount;
-         rt.total_lendable.amount = rt.total_unlent.amount + rt.total_lent.amount;
-      });
+      // deduct calculated delta_total_rent from total_rent
+      pool.total_rent.amount    -= delta_total_rent;
+      // move rented tokens from total_lent to total_unlent
+      pool.total_unlent.amount  += loan.total_staked.amount;
+      pool.total_lent.amount    -= loan.total_staked.amount;
+      pool.total_lendable.amount = pool.total_unlent.amount + pool.total_lent.amount;
+   }
+
+   /**
+    * @brief Adds a loan to the loan wheel bucket of its expiration hour
+    *
+    * @param cpu - whether the loan is a CPU or a NET loan
+    * @param loan - loan to be added, nothing is done if it is already listed
+    */
+   void system_contract::add_loan_to_wheel( bool cpu, const rex_loan& loan )
+   {
+      rex_loan_wheel wheel( get_self(), get_self().value );
+      const uint32_t        hour  = loan.expiration.sec_since_epoch() / 3600;
+      const rex_loan_expiry entry{ loan.expiration, loan.loan_num };
+
+      auto insert = [&]( std::vector<rex_loan_expiry>& entries ) {
+         auto pos = std::lower_bound( entries.begin(), entries.end(), entry );
+         if ( pos != entries.end() && !(entry < *pos) ) {
+            return false;
+         }
+         entries.insert( pos, entry );
+         return true;
+      };
+
+      auto bitr = wheel.find( hour );
+      if ( bitr == wheel.end() ) {
+         wheel.emplace( get_self(), [&]( auto& b ) {
+            b.hour = hour;
+            insert( cpu ? b.cpu_loans : b.net_loans );
+         });
+      } else {
+         rex_loan_bucket bucket = *bitr;
+         if ( insert( cpu ? bucket.cpu_loans : bucket.net_loans ) ) {
+            wheel.modify( bitr, same_payer, [&]( auto& b ) {
+               b = std::move( bucket );
+            });
+         }
+      }
+   }
+
+   /**
+    * @brief Removes a loan from the loan wheel, the bucket is erased when it becomes empty
+    *
+    * @param cpu - whether the loan is a CPU or a NET loan
+    * @param loan - loan to be removed, nothing is done if it is not listed
+    */
+   void system_contract::remove_loan_from_wheel( bool cpu, const rex_loan& loan )
+   {
+      rex_loan_wheel wheel( get_self(), get_self().value );
+      auto bitr = wheel.find( loan.expiration.sec_since_epoch() / 3600 );
+      if ( bitr == wheel.end() ) {
+         return;
+      }
+
+      const rex_loan_expiry entry{ loan.expiration, loan.loan_num };
+      rex_loan_bucket bucket = *bitr;
+      auto& entries = cpu ? bucket.cpu_loans : bucket.net_loans;
+      auto pos = std::lower_bound( entries.begin(), entries.end(), entry );
+      if ( pos == entries.end() || entry < *pos ) {
+         return;
+      }
+      entries.erase( pos );
+
+      if ( bucket.cpu_loans.empty() && bucket.net_loans.empty() ) {
+         wheel.erase( bitr );
+      } else {
+         wheel.modify( bitr, same_payer, [&]( auto& b ) {
+            b = std::move( bucket );
+         });
+      }
    }
 
    /**
@@ -507,22 +608,42 @@ namespace eosiosystem {
    /**
     * @brief Performs maintenance operations on expired NET and CPU loans and sellrex orders
     *
+    * rex_pool balances are updated in a copy and stored once at the end of the run, whatever
+    * the number of loans and orders processed. Once every loan is in the loan wheel, expired
+    * loans are read from the due wheel buckets rather than from the `byexpr` indexes. Resource
+    * limits are updated once per loan receiver.
+    *
     * @param max - maximum number of each of the three categories to be processed
     */
    void system_contract::runrex( uint16_t max )
    {
       check( rex_system_initialized(), "rex system not initialized yet" );
 
+      /// transfer from eosio.names to eosio.rex
+      if ( _rexpool.begin()->namebid_proceeds.amount > 0 ) {
+         channel_to_rex( names_account, _rexpool.begin()->namebid_proceeds );
+      }
+
       const auto& pool = _rexpool.begin();
+      rex_pool pool_state = *pool;
+      bool     pool_changed = pool_state.namebid_proceeds.amount > 0;
+      pool_state.namebid_proceeds.amount = 0;
+
+      const time_point now      = current_time_point();
+      const uint32_t   now_hour = now.sec_since_epoch() / 3600;
 
-      auto process_expired_loan = [&]( auto& idx, const auto& itr ) -> std::pair<bool, int64_t> {
+      rex_loan_index_singleton loanidx( get_self(), get_self().value );
+      const bool use_wheel = loanidx.get_or_default().complete;
+
+      auto process_expired_loan = [&]( bool cpu, auto& idx, const auto& itr ) -> std::pair<bool, int64_t> {
          /// update rex_pool in order to delete existing loan
-         remove_loan_from_rex_pool( *itr );
+         remove_loan_from_rex_pool( pool_state, *itr );
+         pool_changed = true;
          bool    delete_loan   = false;
          int64_t delta_stake   = 0;
          /// calculate rented tokens at current price
-         int64_t rented_tokens = exchange_state::get_bancor_output( pool->total_rent.amount,
-                                                                    pool->total_unlent.amount,
+         int64_t rented_tokens = exchange_state::get_bancor_output( pool_state.total_rent.amount,
+                                                                    pool_state.total_unlent.amount,
                                                                     itr->payment.amount );
          /// conditions for loan renewal
          bool renew_loan = itr->payment <= itr->balance        /// loan has sufficient balance
@@ -530,9 +651,10 @@ namespace eosiosystem {
                         && rex_loans_available();              /// no pending sell orders
          if ( renew_loan ) {
             /// update rex_pool in order to account for renewed loan
-            add_loan_to_rex_pool( itr->payment, rented_tokens, false );
+            add_loan_to_rex_pool( pool_state, itr->payment, rented_tokens, false );
             /// update renewed loan fields
             delta_stake = update_renewed_loan( idx, itr, rented_tokens );
+            add_loan_to_wheel( cpu, *itr );
          } else {
             delete_loan = true;
             delta_stake = -( itr->total_staked.amount );
@@ -545,46 +667,89 @@ namespace eosiosystem {
          return { delete_loan, delta_stake };
       };
 
-      /// transfer from eosio.names to eosio.rex
-      if ( pool->namebid_proceeds.amount > 0 ) {
-         channel_to_rex( names_account, pool->namebid_proceeds );
-         _rexpool.modify( pool, same_payer, [&]( auto& rt ) {
-            rt.namebid_proceeds.amount = 0;
-         });
-      }
+      /// stake changes are summed per receiver and applied once after all loans are processed
+      struct resource_delta {
+         name     from;
+         int64_t  net = 0;
+         int64_t  cpu = 0;
+      };
+      boost::container::flat_map<name, resource_delta> resource_deltas;
 
-      /// process cpu loans
-      {
-         rex_cpu_loan_table cpu_loans( get_self(), get_self().value );
-         auto cpu_idx = cpu_loans.get_index<"byexpr"_n>();
-         for ( uint16_t i = 0; i < max; ++i ) {
-            auto itr = cpu_idx.begin();
-            if ( itr == cpu_idx.end() || itr->expiration > current_time_point() ) break;
+      auto process_loan = [&]( bool cpu, auto& idx, const auto& itr ) {
+         auto result = process_expired_loan( cpu, idx, itr );
+         if ( result.second != 0 ) {
+            auto& delta = resource_deltas.emplace( itr->receiver, resource_delta{ itr->from } ).first->second;
+            ( cpu ? delta.cpu : delta.net ) += result.second;
+         }
+
+         if ( result.first )
+            idx.erase( itr );
+      };
+
+      /// process loans listed in the due wheel buckets, in expiration order
+      auto process_wheel = [&]( bool cpu, auto& loans ) {
+         rex_loan_wheel wheel( get_self(), get_self().value );
+         uint16_t processed = 0;
+         for ( auto bitr = wheel.begin(); bitr != wheel.end() && bitr->hour <= now_hour && processed < max; ) {
+            rex_loan_bucket bucket = *bitr;
+            auto& entries = cpu ? bucket.cpu_loans : bucket.net_loans;
+            size_t done = 0;
+            for ( ; done < entries.size() && processed < max && entries[done].expiration <= now; ++done, ++processed ) {
+               auto itr = loans.find( entries[done].loan_num );
+               if ( itr != loans.end() && itr->expiration == entries[done].expiration ) // otherwise a stale entry
+                  process_loan( cpu, loans, itr );
+            }
+            const bool drained = done == entries.size();
+
+            if ( done > 0 ) {
+               entries.erase( entries.begin(), entries.begin() + done );
+               if ( bucket.cpu_loans.empty() && bucket.net_loans.empty() ) {
+                  bitr = wheel.erase( bitr );
+               } else {
+                  wheel.modify( bitr, same_payer, [&]( auto& b ) {
+                     b = std::move( bucket );
+                  });
+                  ++bitr;
+               }
+            } else {
+               ++bitr;
+            }
+            if ( !drained ) break;
+         }
+      };
 
-            auto result = process_expired_loan( cpu_idx, itr );
-            if ( result.second != 0 )
-               update_resource_limits( itr->from, itr->receiver, 0, result.second );
+      /// process loans through the byexpr index while the loan wheel is being backfilled
+      auto process_index = [&]( bool cpu, auto& loans ) {
+         auto idx = loans.template get_index<"byexpr"_n>();
+         for ( uint16_t i = 0; i < max; ++i ) {
+            auto itr = idx.begin();
+            if ( itr == idx.end() || itr->expiration > now ) break;
 
-            if ( result.first )
-               cpu_idx.erase( itr );
+            remove_loan_from_wheel( cpu, *itr );
+            process_loan( cpu, idx, itr );
          }
+      };
+
+      /// process cpu loans
+      {
+         rex_cpu_loan_table cpu_loans( get_self(), get_self().value );
+         if ( use_wheel )
+            process_wheel( true, cpu_loans );
+         else
+            process_index( true, cpu_loans );
       }
 
       /// process net loans
       {
          rex_net_loan_table net_loans( get_self(), get_self().value );
-         auto net_idx = net_loans.get_index<"byexpr"_n>();
-         for ( uint16_t i = 0; i < max; ++i ) {
-            auto itr = net_idx.begin();
-            if ( itr == net_idx.end() || itr->expiration > current_time_point() ) break;
-
-            auto result = process_expired_loan( net_idx, itr );
-            if ( result.second != 0 )
-               update_resource_limits( itr->from, itr->receiver, result.second, 0 );
+         if ( use_wheel )
+            process_wheel( false, net_loans );
+         else
+            process_index( false, net_loans );
+      }
 
-            if ( result.first )
-               net_idx.erase( itr );
-         }
+      for ( const auto& d : resource_deltas ) {
+         update_resource_limits( d.second.from, d.first, d.second.net, d.second.cpu );
       }
 
       /// process sellrex orders
@@ -597,23 +762,42 @@ namespace eosiosystem {
             ++next;
             auto bitr = _rexbalance.find( oitr->owner.value );
             if ( bitr != _rexbalance.end() ) { // should always be true
-               auto result = fill_rex_order( bitr, oitr->rex_requested );
+               auto    result   = fill_rex_order( pool_state, bitr, oitr->rex_requested );
+               int64_t fillable = 0;
+               if ( !result.success ) {
+                  /// fill the part of the order covered by available unlent tokens, the rest stays queued
+                  fillable = get_fillable_rex( pool_state );
+                  if ( fillable > 0 ) {
+                     result = fill_rex_order( pool_state, bitr, asset( fillable, rex_symbol ) );
+                  }
+               }
                if ( result.success ) {
+                  pool_changed = true;
                   const name order_owner = oitr->owner;
                   idx.modify( oitr, same_payer, [&]( auto& order ) {
-                     order.proceeds.amount     = result.proceeds.amount;
-                     order.stake_change.amount = result.stake_change.amount;
-                     order.close();
+                     order.proceeds.amount     += result.proceeds.amount;
+                     order.stake_change.amount += result.stake_change.amount;
+                     if ( fillable > 0 ) {
+                        order.rex_requested.amount -= fillable;
+                     } else {
+                        order.close();
+                     }
                   });
                   /// send dummy action to show owner and proceeds of filled sellrex order
                   rex_results::orderresult_action order_act( rex_account, std::vector<eosio::permission_level>{ } );
                   order_act.send( order_owner, result.proceeds );
                }
+               if ( fillable > 0 ) break; // available unlent tokens are used up
             }
             oitr = next;
          }
       }
 
+      if ( pool_changed ) {
+         _rexpool.modify( pool, same_payer, [&]( auto& rt ) {
+            rt = pool_state;
+         });
+      }
    }
 
    template <typename T>
@@ -633,9 +817,22 @@ namespace eosiosystem {
                                                                  pool->total_unlent.amount,
                                                                  payment.amount );
       check( payment.amount < rented_tokens, "loan price does not favor renting" );
-      add_loan_to_rex_pool( payment, rented_tokens, true );
+      _rexpool.modify( pool, same_payer, [&]( auto& rt ) {
+         add_loan_to_rex_pool( rt, payment, rented_tokens, true );
+      });
+
+      /// with no loans outstanding there is nothing left to backfill into the loan wheel
+      rex_loan_index_singleton loanidx( get_self(), get_self().value );
+      auto loanidx_state = loanidx.get_or_default();
+      if ( !loanidx_state.complete ) {
+         rex_cpu_loan_table cpu_loans( get_self(), get_self().value );
+         rex_net_loan_table net_loans( get_self(), get_self().value );
+         if ( cpu_loans.begin() == cpu_loans.end() && net_loans.begin() == net_loans.end() ) {
+            loanidx.set( rex_loan_index_state{ true, false, 0 }, get_self() );
+         }
+      }
 
-      table.emplace( from, [&]( auto& c ) {
+      auto loan = table.emplace( from, [&]( auto& c ) {
          c.from         = from;
          c.receiver     = receiver;
          c.payment      = payment;
@@ -644,6 +841,7 @@ namespace eosiosystem {
          c.expiration   = current_time_point() + eosio::days(30);
          c.loan_num     = pool->loan_num;
       });
+      add_loan_to_wheel( std::is_same<T, rex_cpu_loan_table>::value, *loan );
 
       rex_results::rentresult_action rentresult_act{ rex_account, std::vector<eosio::permission_level>{ } };
       rentresult_act.send( asset{ rented_tokens, core_symbol() } );
@@ -668,9 +866,23 @@ namespace eosiosystem {
     */
    rex_order_outcome system_contract::fill_rex_order( const rex_balance_table::const_iterator& bitr, const asset& rex )
    {
-      auto rexitr = _rexpool.begin();
-      const int64_t S0 = rexitr->total_lendable.amount;
-      const int64_t R0 = rexitr->total_rex.amount;
+      rex_pool pool = *_rexpool.begin();
+      const auto result = fill_rex_order( pool, bitr, rex );
+      if ( result.success ) {
+         _rexpool.modify( _rexpool.begin(), same_payer, [&]( auto& rt ) {
+            rt = pool;
+         });
+      }
+      return result;
+   }
+
+   /**
+    * @brief Same as above, with REX pool totals updated in `pool`, stored by the caller
+    */
+   rex_order_outcome system_contract::fill_rex_order( rex_pool& pool, const rex_balance_table::const_iterator& bitr, const asset& rex )
+   {
+      const int64_t S0 = pool.total_lendable.amount;
+      const int64_t R0 = pool.total_rex.amount;
       const int64_t p  = (uint128_t(rex.amount) * S0) / R0;
       const int64_t R1 = R0 - rex.amount;
       const int64_t S1 = S0 - p;
@@ -678,16 +890,14 @@ namespace eosiosystem {
       asset stake_change( 0, core_symbol() );
       bool  success = false;
 
-      const int64_t unlent_lower_bound = ( uint128_t(2) * rexitr->total_lent.amount ) / 10;
-      const int64_t available_unlent   = rexitr->total_unlent.amount - unlent_lower_bound; // available_unlent <= 0 is possible
+      const int64_t unlent_lower_bound = ( uint128_t(2) * pool.total_lent.amount ) / 10;
+      const int64_t available_unlent   = pool.total_unlent.amount - unlent_lower_bound; // available_unlent <= 0 is possible
       if ( proceeds.amount <= available_unlent ) {
          const int64_t init_vote_stake_amount = bitr->vote_stake.amount;
          const int64_t current_stake_value    = ( uint128_t(bitr->rex_balance.amount) * S0 ) / R0;
-         _rexpool.modify( rexitr, same_payer, [&]( auto& rt ) {
-            rt.total_rex.amount      = R1;
-            rt.total_lendable.amount = S1;
-            rt.total_unlent.amount   = rt.total_lendable.amount - rt.total_lent.amount;
-         });
+         pool.total_rex.amount      = R1;
+         pool.total_lendable.amount = S1;
+         pool.total_unlent.amount   = pool.total_lendable.amount - pool.total_lent.amount;
          _rexbalance.modify( bitr, same_payer, [&]( auto& rb ) {
             rb.vote_stake.amount   = current_stake_value - proceeds.amount;
             rb.rex_balance.amount -= rex.amount;
@@ -702,6 +912,27 @@ namespace eosiosystem {
       return { success, proceeds, stake_change };
    }
 
+   /**
+    * @brief Returns the amount of REX that can be sold against available unlent tokens
+    *
+    * @param pool - REX pool totals
+    *
+    * @return int64_t - the largest amount of REX whose proceeds are covered by unlent tokens, or
+    * zero if these proceeds would be negligible
+    */
+   int64_t system_contract::get_fillable_rex( const rex_pool& pool )const
+   {
+      const int64_t S0 = pool.total_lendable.amount;
+      const int64_t R0 = pool.total_rex.amount;
+      const int64_t unlent_lower_bound = ( uint128_t(2) * pool.total_lent.amount ) / 10;
+      const int64_t available_unlent   = pool.total_unlent.amount - unlent_lower_bound;
+      if ( available_unlent <= 0 || S0 <= 0 ) {
+         return 0;
+      }
+      const int64_t rex = ( uint128_t(available_unlent) * R0 ) / S0;
+      return ( uint128_t(rex) * S0 ) / R0 > 0 ? rex : 0;
+   }
+
    template <typename T>
    void system_contract::fund_rex_loan( T& table, const name& from, uint64_t loan_num, const asset& payment  )
    {
@@ -774,7 +1005,8 @@ namespace eosiosystem {
     *
     * Checks if user has a scheduled sellrex order that has been filled, completes its processing,
     * and deletes it. Processing entails transfering proceeds to user REX fund and updating user
-    * vote weight. Additional proceeds and stake change can be passed as arguments. This function
+    * vote weight. Proceeds of a partially filled order are processed the same way and the order
+    * stays open for the remaining REX. Additional proceeds and stake change can be passed as arguments. This function
     * is called only by actions pushed by owner.
     *
     * @param owner - owner account name
@@ -793,6 +1025,14 @@ namespace eosiosystem {
       if ( itr != _rexorders.end() ) {
          if ( itr->is_open ) {
             rex_in_sell_order.amount = itr->rex_requested.amount;
+            if ( itr->proceeds.amount != 0 || itr->stake_change.amount != 0 ) {
+               to_fund.amount  += itr->proceeds.amount;
+               to_stake.amount += itr->stake_change.amount;
+               _rexorders.modify( itr, same_payer, [&]( auto& order ) {
+                  order.proceeds.amount     = 0;
+                  order.stake_change.amount = 0;
+               });
+            }
          } else {
             to_fund.amount  += itr->proceeds.amount;
             to_stake.amount += itr->stake_change.amount;
@@ -864,17 +1104,33 @@ namespace eosiosystem {
    /**
     * @brief Updates REX owner maturity buckets
     *
+    * The row is only written if a bucket has matured.
+    *
     * @param bitr - iterator pointing to rex_balance object
     */
    void system_contract::process_rex_maturities( const rex_balance_table::const_iterator& bitr )
    {
       const time_point_sec now = current_time_point();
-      _rexbalance.modify( bitr, same_payer, [&]( auto& rb ) {
-         while ( !rb.rex_maturities.empty() && rb.rex_maturities.front().first <= now ) {
-            rb.matured_rex += rb.rex_maturities.front().second;
-            rb.rex_maturities.pop_front();
-         }
-      });
+      if ( !bitr->rex_maturities.empty() && bitr->rex_maturities.front().first <= now ) {
+         _rexbalance.modify( bitr, same_payer, [&]( auto& rb ) {
+            process_rex_maturities( rb );
+         });
+      }
+   }
+
+   /**
+    * @brief Updates maturity buckets of a rex_balance object being modified
+    *
+    * @param rb - rex_balance object, written by the caller
+    */
+   void system_contract::process_rex_maturities( rex_balance& rb )
+   {
+      const time_point_sec now = current_time_point();
+      auto itr = rb.rex_maturities.begin();
+      for ( ; itr != rb.rex_maturities.end() && itr->first <= now; ++itr ) {
+         rb.matured_rex += itr->second;
+      }
+      rb.rex_maturities.erase( rb.rex_maturities.begin(), itr );
    }
 
    /**
@@ -886,19 +1142,19 @@ namespace eosiosystem {
    void system_contract::consolidate_rex_balance( const rex_balance_table::const_iterator& bitr,
                                                   const asset& rex_in_sell_order )
    {
-      const int64_t rex_in_savings = read_rex_savings( bitr );
       _rexbalance.modify( bitr, same_payer, [&]( auto& rb ) {
+         const int64_t rex_in_savings = read_rex_savings( rb );
          int64_t total  = rb.matured_rex - rex_in_sell_order.amount;
          rb.matured_rex = rex_in_sell_order.amount;
-         while ( !rb.rex_maturities.empty() ) {
-            total += rb.rex_maturities.front().second;
-            rb.rex_maturities.pop_front();
+         for ( const auto& bucket : rb.rex_maturities ) {
+            total += bucket.second;
          }
+         rb.rex_maturities.clear();
          if ( total > 0 ) {
             rb.rex_maturities.emplace_back( get_rex_maturity(), total );
          }
+         put_rex_savings( rb, rex_in_savings );
       });
-      put_rex_savings( bitr, rex_in_savings );
    }
 
    /**
@@ -974,12 +1230,27 @@ namespace eosiosystem {
    {
       asset init_rex_stake( 0, core_symbol() );
       asset current_rex_stake( 0, core_symbol() );
+
+      /// balance, maturity buckets and savings are all updated in the single write of the row
+      auto add_maturity = [&]( auto& rb ) {
+         const int64_t rex_in_savings = read_rex_savings( rb );
+         process_rex_maturities( rb );
+         const time_point_sec maturity = get_rex_maturity();
+         if ( !rb.rex_maturities.empty() && rb.rex_maturities.back().first == maturity ) {
+            rb.rex_maturities.back().second += rex_received.amount;
+         } else {
+            rb.rex_maturities.emplace_back( maturity, rex_received.amount );
+         }
+         put_rex_savings( rb, rex_in_savings );
+      };
+
       auto bitr = _rexbalance.find( owner.value );
       if ( bitr == _rexbalance.end() ) {
-         bitr = _rexbalance.emplace( owner, [&]( auto& rb ) {
+         _rexbalance.emplace( owner, [&]( auto& rb ) {
             rb.owner       = owner;
             rb.vote_stake  = payment;
             rb.rex_balance = rex_received;
+            add_maturity( rb );
          });
          current_rex_stake.amount = payment.amount;
       } else {
@@ -988,21 +1259,11 @@ namespace eosiosystem {
             rb.rex_balance.amount += rex_received.amount;
             rb.vote_stake.amount   = ( uint128_t(rb.rex_balance.amount) * _rexpool.begin()->total_lendable.amount )
                                      / _rexpool.begin()->total_rex.amount;
+            add_maturity( rb );
          });
          current_rex_stake.amount = bitr->vote_stake.amount;
       }
 
-      const int64_t rex_in_savings = read_rex_savings( bitr );
-      process_rex_maturities( bitr );
-      _rexbalance.modify( bitr, same_payer, [&]( auto& rb ) {
-         const time_point_sec maturity = get_rex_maturity();
-         if ( !rb.rex_maturities.empty() && rb.rex_maturities.back().first == maturity ) {
-            rb.rex_maturities.back().second += rex_received.amount;
-         } else {
-            rb.rex_maturities.emplace_back( maturity, rex_received.amount );
-         }
-      });
-      put_rex_savings( bitr, rex_in_savings );
       return current_rex_stake - init_rex_stake;
    }
 
@@ -1011,21 +1272,20 @@ namespace eosiosystem {
     *
     * Reads and (temporarily) removes REX savings bucket from REX maturities in order to
     * allow uniform processing of remaining buckets as savings is a special case. This
-    * function is used in conjunction with put_rex_savings.
+    * function is used in conjunction with put_rex_savings, on a rex_balance object being
+    * modified.
     *
-    * @param bitr - iterator pointing to rex_balance object
+    * @param rb - rex_balance object, written by the caller
     *
     * @return int64_t - amount of REX in savings bucket
     */
-   int64_t system_contract::read_rex_savings( const rex_balance_table::const_iterator& bitr )
+   int64_t system_contract::read_rex_savings( rex_balance& rb )
    {
       int64_t rex_in_savings = 0;
       static const time_point_sec end_of_days = time_point_sec::maximum();
-      if ( !bitr->rex_maturities.empty() && bitr->rex_maturities.back().first == end_of_days ) {
-         _rexbalance.modify( bitr, same_payer, [&]( auto& rb ) {
-            rex_in_savings = rb.rex_maturities.back().second;
-            rb.rex_maturities.pop_back();
-         });
+      if ( !rb.rex_maturities.empty() && rb.rex_maturities.back().first == end_of_days ) {
+         rex_in_savings = rb.rex_maturities.back().second;
+         rb.rex_maturities.pop_back();
       }
       return rex_in_savings;
    }
@@ -1033,20 +1293,18 @@ namespace eosiosystem {
    /**
     * @brief Adds a specified REX amount to savings bucket
     *
-    * @param bitr - iterator pointing to rex_balance object
+    * @param rb - rex_balance object, written by the caller
     * @param rex - amount of REX to be added
     */
-   void system_contract::put_rex_savings( const rex_balance_table::const_iterator& bitr, int64_t rex )
+   void system_contract::put_rex_savings( rex_balance& rb, int64_t rex )
    {
       if ( rex == 0 ) return;
       static const time_point_sec end_of_days = time_point_sec::maximum();
-      _rexbalance.modify( bitr, same_payer, [&]( auto& rb ) {
-         if ( !rb.rex_maturities.empty() && rb.rex_maturities.back().first == end_of_days ) {
-            rb.rex_maturities.back().second += rex;
-         } else {
-            rb.rex_maturities.emplace_back( end_of_days, rex );
-         }
-      });
+      if ( !rb.rex_maturities.empty() && rb.rex_maturities.back().first == end_of_days ) {
+         rb.rex_maturities.back().second += rex;
+      } else {
+         rb.rex_maturities.emplace_back( end_of_days, rex );
+      }
    }
 
    /**
@@ -23,19 +23,16 @@ namespace eosiosystem {
   }
 
   void system_contract::reset_schedule_metrics(name producer = name(0)) {
-    for (auto &pm : _gschedule_metrics.producers_metric) {
-      if (producer != name(0) && pm.bp_name == producer) pm.missed_blocks_per_cycle = MAX_BLOCK_PER_CYCLE - 1;
-      else pm.missed_blocks_per_cycle = MAX_BLOCK_PER_CYCLE;
-    }
+    for (auto &pm : _gschedule_metrics.producers_metric) pm.missed_blocks_per_cycle = MAX_BLOCK_PER_CYCLE;
+
+    if (producer == name(0)) return;
+    auto pm = _gschedule_metrics.find_metric(producer);
+    if (pm != nullptr) pm->missed_blocks_per_cycle = MAX_BLOCK_PER_CYCLE - 1;
   }
 
   void system_contract::update_producer_missed_blocks(name producer) {
-    for (auto &pm : _gschedule_metrics.producers_metric) {
-      if (pm.bp_name == producer && pm.missed_blocks_per_cycle > 0) {
-        pm.missed_blocks_per_cycle--;
-        break;
-      }
-    }
+    auto pm = _gschedule_metrics.find_metric(producer);
+    if (pm != nullptr && pm->missed_blocks_per_cycle > 0) pm->missed_blocks_per_cycle--;
   }
 
   bool system_contract::is_new_schedule_activated(capi_name active_schedule[], uint32_t size) {
@@ -66,15 +63,26 @@ namespace eosiosystem {
     return true;
   }
 
-  bool system_contract::check_missed_blocks(block_timestamp timestamp, name producer) {
+  bool system_contract::is_proposed_schedule_active(uint32_t active_schedule_version) {
+    if (!_gschedule_metrics.proposed_schedule_version.has_value()) {
+      // metrics written before the proposed version was stored, compare the names once and remember the version
+      auto producers_schedule = get_active_producers();
+      if (_gstate.last_producer_schedule_size != producers_schedule.size() || !is_new_schedule_activated(producers_schedule)) return false;
+
+      _gschedule_metrics.proposed_schedule_version.emplace(active_schedule_version);
+    }
+
+    return active_schedule_version >= _gschedule_metrics.proposed_schedule_version.value();
+  }
+
+  bool system_contract::check_missed_blocks(block_timestamp timestamp, name producer, uint32_t active_schedule_version) {
     if (producer == "eosio"_n) {
       _gschedule_metrics.block_counter_correction++;
       _gschedule_metrics.last_onblock_caller = producer;
       return false;
     }
 
-    auto producers_schedule = get_active_producers();
-    bool is_activated = _gstate.last_producer_schedule_size == producers_schedule.size() && is_new_schedule_activated(producers_schedule);
+    bool is_activated = is_proposed_schedule_active(active_schedule_version);
 
     if (!is_activated) {
       if (_gschedule_metrics.last_onblock_caller != producer) _gschedule_metrics.block_counter_correction = 1;
@@ -84,12 +92,8 @@ namespace eosiosystem {
       return false;
     } else if (_gschedule_metrics.block_counter_correction > 0) {
       if (_gschedule_metrics.last_onblock_caller == "eosio"_n) {
-        for (auto &pm : _gschedule_metrics.producers_metric) {
-          if (pm.bp_name == producer) {
-            pm.missed_blocks_per_cycle -= uint32_t(_gschedule_metrics.block_counter_correction);
-            break;
-          }
-        }
+        auto pm = _gschedule_metrics.find_metric(producer);
+        if (pm != nullptr) pm->missed_blocks_per_cycle -= uint32_t(_gschedule_metrics.block_counter_correction);
       } else {
           reset_schedule_metrics();
           _gschedule_metrics.block_counter_correction = -3;
@@ -116,17 +120,13 @@ namespace eosiosystem {
     }
 
     if (_gschedule_metrics.last_onblock_caller != producer) {
-      for (auto &pm : _gschedule_metrics.producers_metric) {
-        if (pm.bp_name == producer) {                       
-          if (pm.missed_blocks_per_cycle != MAX_BLOCK_PER_CYCLE) {        
-            _gschedule_metrics.last_onblock_caller = producer;
-            return true;
-          }
-          break;
-        }
+      auto pm = _gschedule_metrics.find_metric(producer);
+      if (pm != nullptr && pm->missed_blocks_per_cycle != MAX_BLOCK_PER_CYCLE) {
+        _gschedule_metrics.last_onblock_caller = producer;
+        return true;
       }
     }
-    
+
     update_producer_missed_blocks(producer);
     _gschedule_metrics.last_onblock_caller = producer;
 
@@ -24,12 +24,16 @@ void system_contract::update_rotation_time(block_timestamp block_time) {
 }
 
 void system_contract::update_missed_blocks_per_rotation() {
-  auto active_schedule_size =
-      std::distance(_gschedule_metrics.producers_metric.begin(),
-                    _gschedule_metrics.producers_metric.end());
+  auto active_schedule_size = _gschedule_metrics.producers_metric.size();
   uint16_t max_kick_bps = uint16_t(active_schedule_size / 7);
 
-  std::vector<producer_info> prods;
+  // only the fields the kick order needs, the producer rows are modified through the iterators
+  struct kick_candidate {
+    producers_table::const_iterator pitr;
+    uint32_t missed_blocks;
+    double total_votes;
+  };
+  std::vector<kick_candidate> candidates;
 
   for (auto &pm : _gschedule_metrics.producers_metric) {
     auto pitr = _producers.find(pm.bp_name.value);
@@ -43,43 +47,39 @@ void system_contract::update_missed_blocks_per_rotation() {
         });
       }
 
-      if (pitr->missed_blocks_per_rotation > 0)
-        prods.emplace_back(*pitr);
+      if (pitr->missed_blocks_per_rotation > 0 && max_kick_bps > 0 &&
+          crossed_missed_blocks_threshold(pitr->missed_blocks_per_rotation,
+                                          uint32_t(active_schedule_size)))
+        candidates.push_back({pitr, pitr->missed_blocks_per_rotation, pitr->total_votes});
     }
   }
 
-  std::sort(prods.begin(), prods.end(), [](const producer_info &p1,
-                                           const producer_info &p2) {
-    if (p1.missed_blocks_per_rotation != p2.missed_blocks_per_rotation)
-      return p1.missed_blocks_per_rotation > p2.missed_blocks_per_rotation;
+  // most missed blocks first, the least voted producer first among equals
+  auto kicks = std::min(candidates.size(), size_t(max_kick_bps));
+  std::partial_sort(candidates.begin(), candidates.begin() + kicks, candidates.end(),
+                    [](const kick_candidate &c1, const kick_candidate &c2) {
+    if (c1.missed_blocks != c2.missed_blocks)
+      return c1.missed_blocks > c2.missed_blocks;
     else
-      return p1.total_votes < p2.total_votes;
+      return c1.total_votes < c2.total_votes;
   });
 
-  for (auto &prod : prods) {
-    auto pitr = _producers.find(prod.owner.value);
-
-    if (crossed_missed_blocks_threshold(pitr->missed_blocks_per_rotation,
-                                        uint32_t(active_schedule_size)) &&
-        max_kick_bps > 0) {
-      _producers.modify(pitr, same_payer, [&](auto &p) {
-        p.lifetime_missed_blocks += p.missed_blocks_per_rotation;
-        p.kick(kick_type::REACHED_TRESHOLD);
-      });
-      max_kick_bps--;
-    } else
-      break;
+  for (size_t i = 0; i < kicks; i++) {
+    _producers.modify(candidates[i].pitr, same_payer, [&](auto &p) {
+      p.lifetime_missed_blocks += p.missed_blocks_per_rotation;
+      p.kick(kick_type::REACHED_TRESHOLD);
+    });
   }
 }
 
 void system_contract::restart_missed_blocks_per_rotation(
-    std::vector<eosio::producer_key> prods) {
-  // restart all missed blocks to bps and sbps
-  for (size_t i = 0; i < prods.size(); i++) {
-    auto bp_name = prods[i].producer_name;
-    auto pitr = _producers.find(bp_name.value);
+    const std::vector<eosio::producer_key> &prods) {
+  // restart all missed blocks to bps and sbps, rows without missed blocks or kicks are left untouched
+  for (const auto &prod : prods) {
+    auto pitr = _producers.find(prod.producer_name.value);
 
-    if (pitr != _producers.end()) {
+    if (pitr != _producers.end() &&
+        (pitr->missed_blocks_per_rotation > 0 || pitr->times_kicked > 0)) {
       _producers.modify(pitr, same_payer, [&](auto &p) {
         if (p.times_kicked > 0 && p.missed_blocks_per_rotation == 0) {
           p.times_kicked--;
@@ -95,10 +95,20 @@ void system_contract::restart_missed_blocks_per_rotation(
      return index >= low_bound && index < up_bound;
    } 
 
-std::vector<eosio::producer_key> system_contract::check_rotation_state( std::vector<eosio::producer_key> prods, block_timestamp block_time) {
+// position of producer in prods, checked first at the index it was rotated from, prods.size() if missing
+uint32_t system_contract::find_rotated_producer(const std::vector<eosio::producer_key> &prods, name producer, uint32_t index) {
+  if (index < prods.size() && prods[index].producer_name == producer) return index;
+
+  for (uint32_t i = 0; i < prods.size(); i++) {
+    if (prods[i].producer_name == producer) return i;
+  }
+  return prods.size();
+}
+
+void system_contract::check_rotation_state( std::vector<eosio::producer_key> &prods, block_timestamp block_time) {
       uint32_t total_active_voted_prods = prods.size(); 
-      std::vector<eosio::producer_key>::iterator it_bp = prods.end();
-      std::vector<eosio::producer_key>::iterator it_sbp = prods.end();
+      uint32_t bp_index = total_active_voted_prods;
+      uint32_t sbp_index = total_active_voted_prods;
 
       if (_grotation.next_rotation_time <= block_time) {
         
@@ -106,13 +116,10 @@ std::vector<eosio::producer_key> system_contract::check_rotation_state( std::vec
           _grotation.bp_out_index = _grotation.bp_out_index >= TOP_PRODUCERS - 1 ? 0 : _grotation.bp_out_index + 1;
           _grotation.sbp_in_index = _grotation.sbp_in_index >= total_active_voted_prods - 1 ? TOP_PRODUCERS : _grotation.sbp_in_index + 1;
 
-          name bp_name = prods[_grotation.bp_out_index].producer_name;
-          name sbp_name = prods[_grotation.sbp_in_index].producer_name;
-
-          it_bp = prods.begin() + int32_t(_grotation.bp_out_index);
-          it_sbp = prods.begin() + int32_t(_grotation.sbp_in_index);
+          bp_index = _grotation.bp_out_index;
+          sbp_index = _grotation.sbp_in_index;
 
-          set_bps_rotation(bp_name, sbp_name);
+          set_bps_rotation(prods[bp_index].producer_name, prods[sbp_index].producer_name);
         } 
 
         update_rotation_time(block_time);
@@ -120,58 +127,31 @@ std::vector<eosio::producer_key> system_contract::check_rotation_state( std::vec
       }
       else {
         if(_grotation.bp_currently_out != name(0) && _grotation.sbp_currently_in != name(0)) {
-          auto bp_name = _grotation.bp_currently_out;
-          it_bp = std::find_if(prods.begin(), prods.end(), [&bp_name](const eosio::producer_key &g) {
-            return g.producer_name == bp_name; 
-          });
-
-          auto sbp_name = _grotation.sbp_currently_in;
-          it_sbp = std::find_if(prods.begin(), prods.end(), [&sbp_name](const eosio::producer_key &g) {
-            return g.producer_name == sbp_name; 
-          });
-          auto _bp_index = std::distance(prods.begin(), it_bp);
-          auto _sbp_index = std::distance(prods.begin(), it_sbp);
-
-          if(it_bp == prods.end() || it_sbp == prods.end()) {
+          // the rotated producers usually keep the positions they were rotated at
+          bp_index = find_rotated_producer(prods, _grotation.bp_currently_out, _grotation.bp_out_index);
+          sbp_index = find_rotated_producer(prods, _grotation.sbp_currently_in, _grotation.sbp_in_index);
+
+          if(bp_index == total_active_voted_prods || sbp_index == total_active_voted_prods) {
               set_bps_rotation(name(0), name(0));
+              bp_index = sbp_index = total_active_voted_prods;
 
             if(total_active_voted_prods < TOP_PRODUCERS) {
               _grotation.bp_out_index = TOP_PRODUCERS;
               _grotation.sbp_in_index = MAX_PRODUCERS+1;
             }
           } else if (total_active_voted_prods > TOP_PRODUCERS && 
-                    (!is_in_range(_bp_index, 0, TOP_PRODUCERS) || !is_in_range(_sbp_index, TOP_PRODUCERS, MAX_PRODUCERS))) {
+                    (!is_in_range(bp_index, 0, TOP_PRODUCERS) || !is_in_range(sbp_index, TOP_PRODUCERS, MAX_PRODUCERS))) {
               set_bps_rotation(name(0), name(0));
-              it_bp = prods.end();
-              it_sbp = prods.end();
+              bp_index = sbp_index = total_active_voted_prods;
           }
         }
     }
 
-      std::vector<eosio::producer_key>  top_producers;
-      
       //Rotation
-      if(it_bp != prods.end() && it_sbp != prods.end()) {
-        for ( auto pIt = prods.begin(); pIt != prods.end(); ++pIt) {
-          auto i = std::distance(prods.begin(), pIt); 
-          // print("\ni-> ", i);
-          if(i > TOP_PRODUCERS - 1) break;
-
-          if(pIt->producer_name == it_bp->producer_name) {
-            // print("\nprod sbp added to schedule -> ", name{it_sbp->producer_name});
-            top_producers.emplace_back(*it_sbp);
-          } else {
-            // print("\nprod bp added to schedule -> ", name{pIt->producer_name});
-            top_producers.emplace_back(*pIt);
-          } 
-        }
+      if(bp_index != total_active_voted_prods && sbp_index != total_active_voted_prods) {
+        prods[bp_index] = prods[sbp_index];
       } 
-      else {
-        top_producers = prods;
-        if(prods.size() > TOP_PRODUCERS) top_producers.resize(TOP_PRODUCERS);
-        else top_producers.resize(prods.size());
-      }
 
-  return top_producers;
+      if(prods.size() > TOP_PRODUCERS) prods.resize(TOP_PRODUCERS);
 }
 }
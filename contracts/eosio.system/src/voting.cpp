@@ -1,5 +1,6 @@
 #include <eosio.system/eosio.system.hpp>
 
+#include <eosio/crypto.hpp>
 #include <eosio/eosio.hpp>
 #include <eosio/datastream.hpp>
 #include <eosio/serialize.hpp>
@@ -85,43 +86,70 @@ namespace eosiosystem {
    void system_contract::update_elected_producers( const block_timestamp& block_time ) {
       _gstate.last_producer_schedule_update = block_time;
 
-      auto idx = _producers.get_index<"prototalvote"_n>();
+      // tallies are only partially rebuilt while a vote reconciliation is in progress
+      if( _greconcile.active ) return;
 
-      uint32_t totalActiveVotedProds = uint32_t(std::distance(idx.begin(), idx.end()));
-      totalActiveVotedProds = totalActiveVotedProds > MAX_PRODUCERS ? MAX_PRODUCERS : totalActiveVotedProds;
+      auto idx = _producers.get_index<"prototalvote"_n>();
 
+      // producers are sorted by votes with inactive and unvoted producers last, stop at the first one
       std::vector<eosio::producer_key> prods;
-      prods.reserve(size_t(totalActiveVotedProds));
+      prods.reserve(MAX_PRODUCERS);
 
-      for ( auto it = idx.cbegin(); it != idx.cend() && prods.size() < totalActiveVotedProds && it->total_votes > 0 && it->active(); ++it ) {
+      for ( auto it = idx.cbegin(); it != idx.cend() && prods.size() < MAX_PRODUCERS && it->total_votes > 0 && it->active(); ++it ) {
          prods.emplace_back( eosio::producer_key{it->owner, it->producer_key} );
       }
 
-      std::vector<eosio::producer_key> top_producers = check_rotation_state(prods, block_time);
+      // leaves the top producers in prods, with the rotated standby in place of the rotated out producer
+      check_rotation_state(prods, block_time);
 
       /// sort by producer name
-      std::sort( top_producers.begin(), top_producers.end() );
+      std::sort( prods.begin(), prods.end() );
+
+      // the last proposed schedule is either pending or active, proposing it again is a no-op
+      auto packed_schedule = eosio::pack(prods);
+      auto schedule_hash = eosio::sha256(packed_schedule.data(), packed_schedule.size());
+      if (_gschedule_metrics.proposed_schedule_hash.has_value() && _gschedule_metrics.proposed_schedule_hash.value() == schedule_hash) return;
 
-      auto schedule_version = set_proposed_producers(top_producers);
+      auto schedule_version = set_proposed_producers(prods);
       if (schedule_version >= 0) {
         print("\n**new schedule was proposed**");
+        _gschedule_metrics.proposed_schedule_hash.emplace(schedule_hash);
         
         _gstate.last_proposed_schedule_update = block_time;
 
         _gschedule_metrics.producers_metric.erase( _gschedule_metrics.producers_metric.begin(), _gschedule_metrics.producers_metric.end());
         
+        // prods is sorted by name, which keeps producers_metric searchable with find_metric
         std::vector<producer_metric> psm;
-        std::for_each(top_producers.begin(), top_producers.end(), [&psm](auto &tp) {
+        std::for_each(prods.begin(), prods.end(), [&psm](auto &tp) {
           auto bp_name = tp.producer_name;
           psm.emplace_back(producer_metric{ bp_name, 12 });
         });
  
         _gschedule_metrics.producers_metric = psm;
+        _gschedule_metrics.proposed_schedule_version.emplace(uint32_t(schedule_version));
         
-        _gstate.last_producer_schedule_size = static_cast<decltype(_gstate.last_producer_schedule_size)>(top_producers.size());
+        _gstate.last_producer_schedule_size = static_cast<decltype(_gstate.last_producer_schedule_size)>(prods.size());
       }
    }
 
+   /*
+   * Vote weight curve, (sin(M_PI * n / MAX_VOTE_PRODUCERS - M_PI_2) + 1.0) / 2.0 for n = 0 .. MAX_VOTE_PRODUCERS.
+   * The entries are the exact doubles the formula evaluates to with the contract's libm, written as hex literals
+   * so vote weights stay bit-identical to the ones already stored in the producers and voters tables.
+   */
+   static constexpr double vote_weight_curve[] = {
+      0x0.0p+0, 0x1.6703583cc1d00p-9, 0x1.66079b0bff020p-7, 0x1.90f1ecbbab010p-6,
+      0x1.621e288040358p-5, 0x1.126145e9ecd54p-4, 0x1.8722191a02d60p-4, 0x1.07050af98827ep-3,
+      0x1.52cf6d23be850p-3, 0x1.a61b9f7154b44p-3, 0x1.0000000000000p-2, 0x1.2fc036f7cf296p-2,
+      0x1.61c8864680b58p-2, 0x1.958c994ef69c4p-2, 0x1.ca7b3ec987513p-2, 0x1.0000000000000p-1,
+      0x1.1ac2609b3c576p-1, 0x1.3539b35884b1ep-1, 0x1.4f1bbcdcbfa54p-1, 0x1.681fe484186b4p-1,
+      0x1.7ffffffffffffp-1, 0x1.96791823aad2fp-1, 0x1.ab4c24b7105ebp-1, 0x1.be3ebd419df62p-1,
+      0x1.cf1bbcdcbfa54p-1, 0x1.ddb3d742c2656p-1, 0x1.e9de1d77fbfcbp-1, 0x1.f378709a22a80p-1,
+      0x1.fa67e193d0040p-1, 0x1.fe98fca7c33e3p-1, 0x1.0000000000000p+0
+   };
+   static_assert( sizeof(vote_weight_curve) / sizeof(vote_weight_curve[0]) == MAX_VOTE_PRODUCERS + 1, "vote weight curve must cover every producer count" );
+
    /*
    * This function caculates the inverse weight voting. 
    * The maximum weighted vote will be reached if an account votes for the maximum number of registered producers (up to 30 in total).  
@@ -131,6 +159,11 @@ namespace eosiosystem {
        return 0;
      }
 
+     uint32_t count = uint32_t(amountVotedProducers);
+     if (count == amountVotedProducers && count <= MAX_VOTE_PRODUCERS) {
+       return (vote_weight_curve[count] * staked);
+     }
+
      double percentVoted = amountVotedProducers / MAX_VOTE_PRODUCERS;
      double voteWeight = (sin(M_PI * percentVoted - M_PI_2) + 1.0) / 2.0;
      return (voteWeight * staked);
@@ -146,7 +179,32 @@ namespace eosiosystem {
       }
    }
 
+   void system_contract::votebatch( const std::vector<vote_entry>& votes ) {
+      check( votes.size() > 0, "vote batch is empty" );
+      producer_deltas_map producer_deltas;
+      for( const auto& v : votes ) {
+         require_auth( v.voter );
+         vote_stake_updater( v.voter );
+         update_votes( v.voter, v.proxy, v.producers, true, producer_deltas );
+      }
+      apply_producer_deltas( producer_deltas, true );
+
+      for( const auto& v : votes ) {
+         auto rex_itr = _rexbalance.find( v.voter.value );
+         if( rex_itr != _rexbalance.end() && rex_itr->rex_balance.amount > 0 ) {
+            check_voting_requirement( v.voter, "voter holding REX tokens must vote for at least 21 producers or for a proxy" );
+         }
+      }
+   }
+
    void system_contract::update_votes( const name& voter_name, const name& proxy, const std::vector<name>& producers, bool voting ) {
+      producer_deltas_map producer_deltas;
+      update_votes( voter_name, proxy, producers, voting, producer_deltas );
+      apply_producer_deltas( producer_deltas, voting );
+   }
+
+   void system_contract::update_votes( const name& voter_name, const name& proxy, const std::vector<name>& producers, bool voting,
+                                       producer_deltas_map& producer_deltas ) {
       //validate input
       if ( proxy ) {
          check( producers.size() == 0, "cannot vote for producers and proxy at same time" );
@@ -160,6 +218,7 @@ namespace eosiosystem {
 
       auto voter = _voters.find( voter_name.value );
       check( voter != _voters.end(), "user must stake before they can vote" ); /// staking creates voter object
+      refresh_stale_voter( voter );
       check( !proxy || !voter->is_proxy, "account registered as a proxy is not allowed to use a proxy" );
 
       auto totalStaked = voter->staked;
@@ -181,7 +240,6 @@ namespace eosiosystem {
       }
 
       auto new_vote_weight = inverse_vote_weight((double)totalStaked, (double) producers.size());
-      boost::container::flat_map<name, std::pair< double, bool > > producer_deltas;
 
       // print("\n Voter : ", voter->last_stake, " = ", voter->last_vote_weight, " = ", proxy, " = ", producers.size(), " = ", totalStaked, " = ", new_vote_weight);
       
@@ -192,6 +250,7 @@ namespace eosiosystem {
          if( voter->proxy ) { 
             auto old_proxy = _voters.find( voter->proxy.value );
             check( old_proxy != _voters.end(), "old proxy not found" ); //data corruption
+            refresh_stale_voter( old_proxy );
             _voters.modify( old_proxy, same_payer, [&]( auto& vp ) {
                vp.proxied_vote_weight -= voter->last_stake;
             });
@@ -200,13 +259,12 @@ namespace eosiosystem {
             // otherwise propagate happens in the case below
             if( proxy != voter->proxy ) {  
                _gstate.total_activated_stake += totalStaked - voter->last_stake;
-               propagate_weight_change( *old_proxy );
+               propagate_weight_change( *old_proxy, producer_deltas );
             }
          } else {
             for( const auto& p : voter->producers ) {
-               auto& d = producer_deltas[p];
-               d.first -= voter->last_vote_weight;
-               d.second = false;
+               // the flag is left alone, another vote in the same batch may have added `p`
+               producer_deltas[p].first -= voter->last_vote_weight;
             }
          }
       }
@@ -215,6 +273,7 @@ namespace eosiosystem {
          auto new_proxy = _voters.find( proxy.value );
          check( new_proxy != _voters.end(), "invalid proxy specified" ); //if ( !voting ) { data corruption } else { wrong vote }
          check( !voting || new_proxy->is_proxy, "proxy not found" );
+         refresh_stale_voter( new_proxy );
         
          _voters.modify( new_proxy, same_payer, [&]( auto& vp ) {
             vp.proxied_vote_weight += voter->staked;
@@ -222,7 +281,7 @@ namespace eosiosystem {
          
          if((*new_proxy).last_vote_weight > 0){
             _gstate.total_activated_stake += totalStaked - voter->last_stake;
-            propagate_weight_change( *new_proxy );
+            propagate_weight_change( *new_proxy, producer_deltas );
          }
       } else {
          if( new_vote_weight >= 0 ) {
@@ -234,33 +293,58 @@ namespace eosiosystem {
          }
       }
 
+      if( voter->proxy != proxy ) {
+         index_delegator( voter_name, voter->proxy, proxy, voter_name );
+      }
+
+      _voters.modify( voter, same_payer, [&]( auto& av ) {
+         av.last_vote_weight = new_vote_weight;
+         av.last_stake = int64_t(totalStaked);
+         av.producers = producers;
+         av.proxy     = proxy;
+      });
+   }
+
+   void system_contract::apply_producer_deltas( const producer_deltas_map& producer_deltas, bool voting ) {
       for( const auto& pd : producer_deltas ) {
          auto pitr = _producers.find( pd.first.value );
          if( pitr != _producers.end() ) {
             if( voting && !pitr->active() && pd.second.second /* from new set */ ) {
                check( false, ( "producer " + pitr->owner.to_string() + " is not currently registered" ).data() );
             }
-            _producers.modify( pitr, same_payer, [&]( auto& p ) {
-               p.total_votes += pd.second.first;
-               if ( p.total_votes < 0 ) { // floating point arithmetics can give small negative numbers
-                  p.total_votes = 0;
-               }
-               _gstate.total_producer_vote_weight += pd.second.first;
-               //check( p.total_votes >= 0, "something bad happened" );
-            });
+            _gstate.total_producer_vote_weight += pd.second.first;
+
+            // producer rows are only rewritten when the deltas are settled
+            auto ditr = _vote_deltas.find( pd.first.value );
+            if( ditr == _vote_deltas.end() ) {
+               _vote_deltas.emplace( get_self(), [&]( auto& d ) {
+                  d.producer = pd.first;
+                  d.delta    = pd.second.first;
+               });
+            } else {
+               _vote_deltas.modify( ditr, same_payer, [&]( auto& d ) {
+                  d.delta += pd.second.first;
+               });
+            }
          } else {
             if( pd.second.second ) {
                check( false, ( "producer " + pd.first.to_string() + " is not registered" ).data() );
             }
          }
       }
+   }
 
-      _voters.modify( voter, same_payer, [&]( auto& av ) {
-         av.last_vote_weight = new_vote_weight;
-         av.last_stake = int64_t(totalStaked);
-         av.producers = producers;
-         av.proxy     = proxy;
-      });
+   void system_contract::settle_vote_deltas() {
+      for( auto ditr = _vote_deltas.begin(); ditr != _vote_deltas.end(); ditr = _vote_deltas.erase( ditr ) ) {
+         auto pitr = _producers.find( ditr->producer.value );
+         if( pitr == _producers.end() ) continue;
+         _producers.modify( pitr, same_payer, [&]( auto& p ) {
+            p.total_votes += ditr->delta;
+            if ( p.total_votes < 0 ) { // floating point arithmetics can give small negative numbers
+               p.total_votes = 0;
+            }
+         });
+      }
    }
 
    void system_contract::regproxy( const name& proxy, bool isproxy ) {
@@ -282,71 +366,173 @@ namespace eosiosystem {
    }
 
    void system_contract::propagate_weight_change( const voter_info& voter ) {
-      check( voter.proxy == name(0) || !voter.is_proxy, "account registered as a proxy is not allowed to use a proxy");
-      
-      auto totalStake = voter.staked;
-      if(voter.is_proxy){
-         totalStake += voter.proxied_vote_weight;
-      } 
-      double new_weight = inverse_vote_weight((double)totalStake, voter.producers.size());
-      double delta = new_weight - voter.last_vote_weight;
-
-      if (voter.proxy) { // this part should never happen since the function is called only on proxies
-         if(voter.last_stake != totalStake){
-            auto &proxy = _voters.get(voter.proxy.value, "proxy not found"); // data corruption
-            _voters.modify(proxy, same_payer, [&](auto &p) { 
-               p.proxied_vote_weight += totalStake - voter.last_stake;
-            });
-            
-            propagate_weight_change(proxy);
+      producer_deltas_map producer_deltas;
+      propagate_weight_change( voter, producer_deltas );
+      apply_producer_deltas( producer_deltas, false );
+   }
+
+   /*
+   * Walks from `voter` up its proxy chain, updating the proxied weight of each proxy on the way, and adds
+   * the weight change of the account that votes for producers to `producer_deltas`. Changes collected for
+   * the same producers are merged, so callers that propagate several times update each producer once.
+   */
+   void system_contract::propagate_weight_change( const voter_info& voter, producer_deltas_map& producer_deltas ) {
+      const voter_info* current = &voter;
+      for( uint32_t length = 1; ; ++length ) {
+         check( length <= max_proxy_chain_length, "proxy chain is too long" ); // data corruption
+         check( current->proxy == name(0) || !current->is_proxy, "account registered as a proxy is not allowed to use a proxy");
+
+         auto totalStake = current->staked;
+         if(current->is_proxy){
+            totalStake += current->proxied_vote_weight;
          }
-      } else {
-         for (auto acnt : voter.producers) {
-            auto &pitr = _producers.get(acnt.value, "producer not found"); // data corruption
-            _producers.modify(pitr, same_payer, [&](auto &p) {
-               p.total_votes += delta;
-               _gstate.total_producer_vote_weight += delta;
+         double new_weight = inverse_vote_weight((double)totalStake, current->producers.size());
+         double delta = new_weight - current->last_vote_weight;
+         int64_t last_stake = current->last_stake;
+
+         _voters.modify(*current, same_payer, [&](auto &v) {
+            v.last_vote_weight = new_weight;
+            v.last_stake = totalStake;
+         });
+
+         if (current->proxy) { // this part should never happen since the function is called only on proxies
+            if(last_stake == totalStake) {
+               break;
+            }
+            auto &proxy = _voters.get(current->proxy.value, "proxy not found"); // data corruption
+            _voters.modify(proxy, same_payer, [&](auto &p) {
+               p.proxied_vote_weight += totalStake - last_stake;
             });
+            current = &proxy;
+         } else {
+            for (auto acnt : current->producers) {
+               producer_deltas[acnt].first += delta;
+            }
+            break;
          }
       }
-      
-      _voters.modify(voter, same_payer, [&](auto &v) { 
-         v.last_vote_weight = new_weight; 
-         v.last_stake = totalStake;
+   }
+
+   void system_contract::refresh_stale_voter( const voters_table::const_iterator& voter ) {
+      if( !_greconcile.active || voter->reserved2 == _greconcile.epoch ) return;
+
+      // producer tallies were zeroed when the reconciliation started, so whatever this voter
+      // cast before then is no longer counted anywhere
+      _voters.modify( voter, same_payer, [&]( auto& v ) {
+         v.last_vote_weight = 0;
+         v.last_stake = 0;
+         v.proxied_vote_weight = 0;
+         v.reserved2 = _greconcile.epoch;
       });
    }
 
-   void system_contract::recalculate_votes(){
-    if (_gstate.total_producer_vote_weight <= -0.1){ // -0.1 threshold for floating point calc ?
-        _gstate.total_producer_vote_weight = 0;
-        _gstate.total_activated_stake = 0;
-        for(auto producer = _producers.begin(); producer != _producers.end(); ++producer){
-            _producers.modify(producer, same_payer, [&](auto &p) {
-                p.total_votes = 0;
+   void system_contract::reconcile_votes( uint16_t max ) {
+      if( !_greconcile.active ) {
+         if( _gstate.total_producer_vote_weight > -0.1 ) return; // -0.1 threshold for floating point calc
+
+         _gstate.total_producer_vote_weight = 0;
+         _gstate.total_activated_stake = 0;
+         // pending deltas belong to the tallies being discarded
+         auto ditr = _vote_deltas.begin();
+         while( ditr != _vote_deltas.end() ) {
+            ditr = _vote_deltas.erase( ditr );
+         }
+         for( auto producer = _producers.begin(); producer != _producers.end(); ++producer ) {
+            _producers.modify( producer, same_payer, [&]( auto& p ) {
+               p.total_votes = 0;
             });
-        }
-        boost::container::flat_map< name, bool> processed_proxies;
-        for (auto voter = _voters.begin(); voter != _voters.end(); ++voter) {
-            if(voter->proxy && !processed_proxies[voter->proxy]){
-                auto proxy = _voters.find(voter->proxy.value);
-                _voters.modify( proxy, same_payer, [&]( auto& av ) {
-                    av.last_vote_weight = 0;
-                    av.last_stake = 0;
-                    av.proxied_vote_weight = 0;
-                });
-                processed_proxies[voter->proxy] = true;
-            }
-            if(!voter->is_proxy || !processed_proxies[voter->owner]){
-                _voters.modify( voter, same_payer, [&]( auto& av ) {
-                    av.last_vote_weight = 0;
-                    av.last_stake = 0;
-                    av.proxied_vote_weight = 0;
-                });
-                processed_proxies[voter->owner] = true;
-            }
-            update_votes(voter->owner, voter->proxy, voter->producers, true);
-        }
-    }
-}
+         }
+
+         _greconcile.active = true;
+         _greconcile.epoch++;
+         _greconcile.cursor = name(0);
+         _greconcile.started = current_time_point();
+      }
+
+      auto voter = _voters.lower_bound( _greconcile.cursor.value );
+      for( uint16_t i = 0; i < max && voter != _voters.end(); ++i, ++voter ) {
+         refresh_stale_voter( voter );
+         if( voter->producers.size() || voter->proxy ) {
+            update_votes( voter->owner, voter->proxy, voter->producers, false );
+         }
+      }
+
+      if( voter == _voters.end() ) {
+         _greconcile.active = false;
+         _greconcile.cursor = name(0);
+      } else {
+         _greconcile.cursor = voter->owner;
+      }
+   }
+
+   void system_contract::reconvotes( const name& user, uint16_t max ) {
+      require_auth( user );
+      check( max > 0, "must replay at least one voter" );
+      check( _greconcile.active || _gstate.total_producer_vote_weight <= -0.1, "no vote reconciliation in progress" );
+
+      reconcile_votes( max );
+   }
+
+   void system_contract::index_delegator( const name& voter, const name& old_proxy, const name& new_proxy, const name& payer ) {
+      // voters not backfilled yet have no row under their old proxy
+      if( old_proxy ) {
+         delegators_table delegators( get_self(), old_proxy.value );
+         auto itr = delegators.find( voter.value );
+         if( itr != delegators.end() ) {
+            delegators.erase( itr );
+         }
+      }
+      if( new_proxy ) {
+         delegators_table delegators( get_self(), new_proxy.value );
+         if( delegators.find( voter.value ) == delegators.end() ) {
+            delegators.emplace( payer, [&]( auto& d ) {
+               d.voter = voter;
+            });
+         }
+      }
+   }
+
+   void system_contract::indexproxied( const name& user, uint16_t max ) {
+      require_auth( user );
+      check( !_gdelegidx.complete, "delegators are already indexed" );
+      check( max > 0, "must index at least one voter" );
+
+      auto voter = _voters.lower_bound( _gdelegidx.cursor.value );
+      for( uint16_t i = 0; i < max && voter != _voters.end(); ++i, ++voter ) {
+         if( voter->proxy ) {
+            index_delegator( voter->owner, name(0), voter->proxy, get_self() );
+         }
+      }
+
+      if( voter == _voters.end() ) {
+         _gdelegidx.complete = true;
+         _gdelegidx.cursor = name(0);
+      } else {
+         _gdelegidx.cursor = voter->owner;
+      }
+   }
+
+   void system_contract::rebuildproxy( const name& proxy ) {
+      require_auth( get_self() );
+      check( _gdelegidx.complete, "delegators are still being indexed" );
+      check( !_greconcile.active, "cannot rebuild a proxy while votes are being reconciled" );
+
+      auto pitr = _voters.find( proxy.value );
+      check( pitr != _voters.end(), "proxy not found" );
+      check( pitr->is_proxy, "account is not a proxy" );
+
+      delegators_table delegators( get_self(), proxy.value );
+      double proxied_vote_weight = 0;
+      for( const auto& d : delegators ) {
+         const auto& voter = _voters.get( d.voter.value, "delegator not found" ); // data corruption
+         check( voter.proxy == proxy, "delegator does not use this proxy" ); // data corruption
+         proxied_vote_weight += voter.last_stake;
+      }
+
+      _voters.modify( pitr, same_payer, [&]( auto& p ) {
+         p.proxied_vote_weight = proxied_vote_weight;
+      });
+      propagate_weight_change( *pitr );
+   }
 
 } /// namespace eosiosystem
@@ -13,6 +13,17 @@ namespace eosio {
 
    using std::string;
 
+   /**
+    * One transfer of a `bulktransfer` action, with the same meaning as the arguments of `transfer`.
+    */
+   struct token_transfer {
+      name     to;
+      asset    quantity;
+      string   memo;
+
+      EOSLIB_SERIALIZE( token_transfer, (to)(quantity)(memo) )
+   };
+
    /**
     * @defgroup eosiotoken eosio.token
     * @ingroup eosiocontracts
@@ -47,7 +58,7 @@ namespace eosio {
          /**
           * Issue action.
           *
-          * @details This action issues to `to` account a `quantity` of tokens.
+          * @details This action issues to `to` account a `quantity` of tokens. The issuer is notified.
           *
           * @param to - the account to issue tokens to, it must be the same as the issuer,
           * @param quntity - the amount of tokens to be issued,
@@ -60,7 +71,7 @@ namespace eosio {
           * Retire action.
           *
           * @details The opposite for create action, if all validations succeed,
-          * it debits the statstable.supply amount.
+          * it debits the statstable.supply amount. The issuer is notified.
           *
           * @param quantity - the quantity of tokens to retire,
           * @param memo - the memo string to accompany the transaction.
@@ -84,6 +95,23 @@ namespace eosio {
                         const name&    to,
                         const asset&   quantity,
                         const string&  memo );
+
+         /**
+          * Bulk transfer action.
+          *
+          * @details Allows the issuer `from` to make several transfers of the same token in one action.
+          * `from` is debited once with the sum of the quantities and every recipient is credited and
+          * notified of the `bulktransfer`. Contracts handling `transfer` notifications do not see these
+          * transfers, a recipient that accounts for incoming transfers must also handle `bulktransfer`.
+          *
+          * @param from - the account to transfer from, must be the issuer of the token,
+          * @param transfers - the recipients, quantities and memos of the transfers.
+          *
+          * @pre `transfers` is not empty and all its quantities are of the same token
+          */
+         [[eosio::action]]
+         void bulktransfer( const name& from, const std::vector<token_transfer>& transfers );
+
          /**
           * Open action.
           *
@@ -151,6 +179,7 @@ namespace eosio {
          using issue_action = eosio::action_wrapper<"issue"_n, &token::issue>;
          using retire_action = eosio::action_wrapper<"retire"_n, &token::retire>;
          using transfer_action = eosio::action_wrapper<"transfer"_n, &token::transfer>;
+         using bulktransfer_action = eosio::action_wrapper<"bulktransfer"_n, &token::bulktransfer>;
          using open_action = eosio::action_wrapper<"open"_n, &token::open>;
          using close_action = eosio::action_wrapper<"close"_n, &token::close>;
       private:
@@ -43,6 +43,9 @@ void token::issue( const name& to, const asset& quantity, const string& memo )
     check( quantity.symbol == st.supply.symbol, "symbol precision mismatch" );
     check( quantity.amount <= st.max_supply.amount - st.supply.amount, "quantity exceeds available supply");
 
+    // lets the issuer contract follow the supply without reading the stats table
+    require_recipient( st.issuer );
+
     statstable.modify( st, same_payer, [&]( auto& s ) {
        s.supply += quantity;
     });
@@ -67,6 +70,8 @@ void token::retire( const asset& quantity, const string& memo )
 
     check( quantity.symbol == st.supply.symbol, "symbol precision mismatch" );
 
+    require_recipient( st.issuer );
+
     statstable.modify( st, same_payer, [&]( auto& s ) {
        s.supply -= quantity;
     });
@@ -100,6 +105,38 @@ void token::transfer( const name&    from,
     add_balance( to, quantity, payer );
 }
 
+void token::bulktransfer( const name& from, const std::vector<token_transfer>& transfers )
+{
+    check( transfers.size() > 0, "no transfers" );
+    require_auth( from );
+    auto sym = transfers.front().quantity.symbol.code();
+    stats statstable( get_self(), sym.raw() );
+    const auto& st = statstable.get( sym.raw() );
+    // recipients only see a bulktransfer notification, transfer handlers of receiving contracts do not run
+    check( from == st.issuer, "only the issuer can bulk transfer" );
+
+    require_recipient( from );
+
+    asset total( 0, st.supply.symbol );
+    for( const auto& t : transfers ) {
+       check( from != t.to, "cannot transfer to self" );
+       check( is_account( t.to ), "to account does not exist");
+       require_recipient( t.to );
+
+       check( t.quantity.is_valid(), "invalid quantity" );
+       check( t.quantity.amount > 0, "must transfer positive quantity" );
+       check( t.quantity.symbol == st.supply.symbol, "symbol precision mismatch" );
+       check( t.memo.size() <= 256, "memo has more than 256 bytes" );
+       total += t.quantity;
+    }
+
+    sub_balance( from, total );
+    for( const auto& t : transfers ) {
+       auto payer = has_auth( t.to ) ? t.to : from;
+       add_balance( t.to, t.quantity, payer );
+    }
+}
+
 void token::sub_balance( const name& owner, const asset& value ) {
    accounts from_acnts( get_self(), owner.value );
 
@@ -11,6 +11,8 @@
 #include "trail.system.hpp"
 #include "trail.tokens.hpp"
 
+#include <eosio.common/tracked_singleton.hpp>
+
 #include <eosio/asset.hpp>
 #include <eosio/eosio.hpp>
 #include <eosio/singleton.hpp>
@@ -29,7 +31,7 @@ public:
 
     ~trail();
 
-    environment_singleton environment;
+    eosiocommon::tracked_singleton<name("environment"), env> environment;
     env env_struct;
 
     #pragma region Constants
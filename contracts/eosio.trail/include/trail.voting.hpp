@@ -128,7 +128,7 @@ struct [[eosio::table, eosio::contract("eosio.trail")]] leaderboard {
 struct [[eosio::table("environment"), eosio::contract("eosio.trail")]] env {
     name publisher;
     vector<uint64_t> totals;
-    uint32_t time_now;
+    uint32_t time_now; //NOTE: refreshed on every action, the stored value is the time of the last environment change
     uint64_t last_ballot_id;
 
     uint64_t primary_key() const { return publisher.value; }
@@ -15,6 +15,7 @@ trail::trail(name self, name code, datastream<const char*> ds) : contract(self,
     } else {
         env_struct = environment.get();
         env_struct.time_now = current_time_point().sec_since_epoch();
+        environment.track(env_struct); //NOTE: time_now alone is not worth a write, it's persisted with the next real change
     }
 }
 
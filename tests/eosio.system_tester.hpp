@@ -540,6 +540,10 @@ public:
       return push_action( name(user), N(rexexec), mvo()("user", user)("max", max) );
    }
 
+   action_result indexloans( const account_name& user, uint16_t max ) {
+      return push_action( name(user), N(indexloans), mvo()("user", user)("max", max) );
+   }
+
    action_result consolidate( const account_name& owner ) {
       return push_action( name(owner), N(consolidate), mvo()("owner", owner) );
    }
@@ -590,6 +594,44 @@ public:
       return get_last_loan( false );
    }
 
+   fc::variant get_loan_index() const {
+      vector<char> data = get_row_by_account( config::system_account_name, config::system_account_name, N(loanidx), N(loanidx) );
+      return data.empty() ? fc::variant() : abi_ser.binary_to_variant( "rex_loan_index_state", data, abi_serializer_max_time );
+   }
+
+   fc::variant get_loan_bucket( uint32_t hour ) const {
+      vector<char> data = get_row_by_account( config::system_account_name, config::system_account_name, N(loanwheel), hour );
+      return data.empty() ? fc::variant() : abi_ser.binary_to_variant( "rex_loan_bucket", data, abi_serializer_max_time );
+   }
+
+   // erases every row of a contract table directly, as if the table had never been written
+   void erase_table( const name& code, const name& scope, const name& table ) {
+      auto& db = control->mutable_db();
+      namespace chain = eosio::chain;
+      const auto* t_id = db.find<chain::table_id_object, chain::by_code_scope_table>( boost::make_tuple( code, scope, table ) );
+      if ( !t_id ) {
+         return;
+      }
+
+      const auto& idx = db.get_index<chain::key_value_index, chain::by_scope_primary>();
+      for ( auto itr = idx.lower_bound( boost::make_tuple( t_id->id ) ); itr != idx.end() && itr->t_id == t_id->id;
+            itr = idx.lower_bound( boost::make_tuple( t_id->id ) ) ) {
+         db.remove( *itr );
+      }
+      db.remove( *t_id );
+   }
+
+   account_name get_row_payer( const name& code, const name& scope, const name& table, const name& primary ) const {
+      const auto& db = control->db();
+      namespace chain = eosio::chain;
+      const auto* t_id = db.find<chain::table_id_object, chain::by_code_scope_table>( boost::make_tuple( code, scope, table ) );
+      if ( !t_id ) {
+         return account_name();
+      }
+      const auto* obj = db.find<chain::key_value_object, chain::by_scope_primary>( boost::make_tuple( t_id->id, primary.value ) );
+      return obj ? obj->payer : account_name();
+   }
+
    fc::variant get_loan_info( const uint64_t& loan_num, bool cpu ) const {
       name table_name = cpu ? N(cpuloan) : N(netloan);
       vector<char> data = get_row_by_account( config::system_account_name, config::system_account_name, table_name, loan_num );
@@ -702,6 +744,14 @@ public:
                           );
    }
 
+   action_result claimrefund( const account_name& bidder ) {
+      return claimrefund( bidder, bidder );
+   }
+
+   action_result claimrefund( const account_name& signer, const account_name& bidder ) {
+      return push_action( name(signer), N(claimrefund), mvo()("bidder", bidder) );
+   }
+
    static fc::variant_object producer_parameters_example( int n ) {
       return mutable_variant_object()
          ("max_block_net_usage", 10000000 + n )
@@ -786,6 +836,34 @@ public:
                          ("producers", producers));
    }
 
+   transaction_trace_ptr votebatch( const vector<account_name>& voters, const fc::variants& votes ) {
+      return base_tester::push_action( config::system_account_name, N(votebatch), voters, mvo()("votes", votes) );
+   }
+
+   static fc::variant vote_entry( const account_name& voter, const std::vector<account_name>& producers, const account_name& proxy = name(0) ) {
+      return mvo()("voter", voter)("proxy", proxy)("producers", producers);
+   }
+
+   action_result checksupply( const account_name& user ) {
+      return push_action( name(user), N(checksupply), mvo()("user", user) );
+   }
+
+   action_result reconvotes( const account_name& user, uint16_t max ) {
+      return push_action( name(user), N(reconvotes), mvo()("user", user)("max", max) );
+   }
+
+   action_result indexproxied( const account_name& user, uint16_t max ) {
+      return push_action( name(user), N(indexproxied), mvo()("user", user)("max", max) );
+   }
+
+   action_result rebuildproxy( const account_name& proxy, bool auth = true ) {
+      return push_action( config::system_account_name, N(rebuildproxy), mvo()("proxy", proxy), auth );
+   }
+
+   bool is_delegator( const account_name& proxy, const account_name& voter ) {
+      return !get_row_by_account( config::system_account_name, proxy, N(delegators), voter ).empty();
+   }
+
    uint32_t last_block_time() const {
       return time_point_sec( control->head_block_time() ).sec_since_epoch();
    }
@@ -810,6 +888,31 @@ public:
       return abi_ser.binary_to_variant( "producer_info", data, abi_serializer_max_time );
    }
 
+   // the producer row as it reads once onblock has settled pending votes and produced blocks
+   fc::variant get_pending_producer_info( const account_name& act ) {
+      vector<char> data = get_row_by_account( config::system_account_name, config::system_account_name, N(producers), act );
+      fc::variant info = abi_ser.binary_to_variant( "producer_info", data, abi_serializer_max_time );
+      if( data.empty() ) {
+         return info;
+      }
+      mutable_variant_object result( info );
+      // votes not yet settled by onblock are kept in votedeltas
+      vector<char> delta = get_row_by_account( config::system_account_name, config::system_account_name, N(votedeltas), act );
+      if( !delta.empty() ) {
+         double total_votes = info["total_votes"].as_double() + abi_ser.binary_to_variant( "vote_delta", delta, abi_serializer_max_time )["delta"].as_double();
+         result( "total_votes", std::max( total_votes, 0.0 ) );
+      }
+      // blocks produced since the last snapshot are counted in prodstats, unpaid blocks only in the current window
+      vector<char> stats = get_row_by_account( config::system_account_name, config::system_account_name, N(prodstats), act );
+      if( !stats.empty() ) {
+         fc::variant s = abi_ser.binary_to_variant( "producer_stats", stats, abi_serializer_max_time );
+         const uint32_t unpaid = s["unpaid_since"].as<uint32_t>() == get_global_state()["last_claimrewards"].as<uint32_t>() ? s["unpaid_blocks"].as<uint32_t>() : 0;
+         result( "unpaid_blocks", info["unpaid_blocks"].as<uint32_t>() + unpaid );
+         result( "lifetime_produced_blocks", info["lifetime_produced_blocks"].as<uint32_t>() + s["lifetime_produced_blocks"].as<uint32_t>() );
+      }
+      return result;
+   }
+
    fc::variant get_producer_info2( const account_name& act ) {
       vector<char> data = get_row_by_account( config::system_account_name, config::system_account_name, N(producers2), act );
       return abi_ser.binary_to_variant( "producer_info2", data, abi_serializer_max_time );
@@ -929,14 +1032,36 @@ public:
       return data.empty() ? fc::variant() : abi_ser.binary_to_variant( "rotation_state", data, abi_serializer_max_time );
    }
 
+   fc::variant get_token_mirror() {
+      vector<char> data = get_row_by_account( config::system_account_name, config::system_account_name, N(tokenmirror), N(tokenmirror) );
+      return data.empty() ? fc::variant() : abi_ser.binary_to_variant( "token_mirror_state", data, abi_serializer_max_time );
+   }
+
+   fc::variant get_reconcile_state() {
+      vector<char> data = get_row_by_account( config::system_account_name, config::system_account_name, N(reconcile), N(reconcile) );
+      return data.empty() ? fc::variant() : abi_ser.binary_to_variant( "vote_reconcile_state", data, abi_serializer_max_time );
+   }
+
    fc::variant get_refund_request( name account ) {
       vector<char> data = get_row_by_account( config::system_account_name, account, N(refunds), account );
       return data.empty() ? fc::variant() : abi_ser.binary_to_variant( "refund_request", data, abi_serializer_max_time );
    }
 
    fc::variant get_payment_info( name account ) {
+      int64_t pay = 0;
       vector<char> data = get_row_by_account( config::system_account_name, config::system_account_name, N(payments), account );
-      return data.empty() ? fc::variant() : abi_ser.binary_to_variant( "payment_info", data, abi_serializer_max_time );
+      if( !data.empty() ) {
+         pay += abi_ser.binary_to_variant( "payment_info", data, abi_serializer_max_time )["pay"].as<asset>().get_amount();
+      }
+      // pay accumulated on the reward index since the last claim
+      data = get_row_by_account( config::system_account_name, config::system_account_name, N(prodrewards), account );
+      if( !data.empty() ) {
+         fc::variant reward = abi_ser.binary_to_variant( "producer_reward", data, abi_serializer_max_time );
+         vector<char> index = get_row_by_account( config::system_account_name, config::system_account_name, N(rewardindex), N(rewardindex) );
+         const int64_t pay_per_share = abi_ser.binary_to_variant( "reward_index_state", index, abi_serializer_max_time )["pay_per_share"].as<int64_t>();
+         pay += reward["unclaimed"].as<int64_t>() + reward["shares"].as<int64_t>() * ( pay_per_share - reward["pay_index"].as<int64_t>() );
+      }
+      return pay == 0 ? fc::variant() : fc::variant( mvo()("bp", account)("pay", asset( pay, symbol{CORE_SYM} )) );
    }
 
    abi_serializer initialize_multisig() {
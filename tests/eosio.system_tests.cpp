@@ -72,7 +72,7 @@ BOOST_FIXTURE_TEST_CASE( bp_rotations, eosio_system_tester ) try {
       for (const auto& p: producer_names) {
          BOOST_REQUIRE_EQUAL( success(), regproducer(p) );
          produce_blocks(1);
-         BOOST_TEST(0 == get_producer_info(p)["total_votes"].as<double>());
+         BOOST_TEST(0 == get_pending_producer_info(p)["total_votes"].as<double>());
       }
    }
 
@@ -1027,7 +1027,7 @@ BOOST_FIXTURE_TEST_CASE( producer_register_unregister, eosio_system_tester ) try
                         )
    );
 
-   auto info = get_producer_info( "alice1111111" );
+   auto info = get_pending_producer_info( "alice1111111" );
    BOOST_REQUIRE_EQUAL( "alice1111111", info["owner"].as_string() );
    BOOST_REQUIRE_EQUAL( 0, info["total_votes"].as_double() );
    BOOST_REQUIRE_EQUAL( "http://block.one", info["url"].as_string() );
@@ -1041,7 +1041,7 @@ BOOST_FIXTURE_TEST_CASE( producer_register_unregister, eosio_system_tester ) try
                                                ("location", 1)
                         )
    );
-   info = get_producer_info( "alice1111111" );
+   info = get_pending_producer_info( "alice1111111" );
    BOOST_REQUIRE_EQUAL( "alice1111111", info["owner"].as_string() );
    BOOST_REQUIRE_EQUAL( key, fc::crypto::public_key(info["producer_key"].as_string()) );
    BOOST_REQUIRE_EQUAL( "http://block.two", info["url"].as_string() );
@@ -1055,7 +1055,7 @@ BOOST_FIXTURE_TEST_CASE( producer_register_unregister, eosio_system_tester ) try
                                                ("location", 2)
                         )
    );
-   info = get_producer_info( "alice1111111" );
+   info = get_pending_producer_info( "alice1111111" );
    BOOST_REQUIRE_EQUAL( "alice1111111", info["owner"].as_string() );
    BOOST_REQUIRE_EQUAL( key2, fc::crypto::public_key(info["producer_key"].as_string()) );
    BOOST_REQUIRE_EQUAL( "http://block.two", info["url"].as_string() );
@@ -1066,7 +1066,7 @@ BOOST_FIXTURE_TEST_CASE( producer_register_unregister, eosio_system_tester ) try
                                                ("producer",  "alice1111111")
                         )
    );
-   info = get_producer_info( "alice1111111" );
+   info = get_pending_producer_info( "alice1111111" );
    //key should be empty
    BOOST_REQUIRE_EQUAL( fc::crypto::public_key(), fc::crypto::public_key(info["producer_key"].as_string()) );
    //everything else should stay the same
@@ -1098,7 +1098,7 @@ BOOST_FIXTURE_TEST_CASE( vote_for_producer, eosio_system_tester, * boost::unit_t
    );
    // ALICE is the SINGLE producer in this test case, so we can also test the total_producer_vote_weight for all the actions
 
-   auto prod = get_producer_info( "alice1111111" );
+   auto prod = get_pending_producer_info( "alice1111111" );
    BOOST_REQUIRE_EQUAL( "alice1111111", prod["owner"].as_string() );
    BOOST_REQUIRE_EQUAL( 0, prod["total_votes"].as_double() );
    BOOST_REQUIRE_EQUAL( "http://block.one", prod["url"].as_string() );
@@ -1111,18 +1111,18 @@ BOOST_FIXTURE_TEST_CASE( vote_for_producer, eosio_system_tester, * boost::unit_t
    BOOST_REQUIRE_EQUAL( core_sym::from_string("1988.8889"), get_balance( "bob111111111" ) );
    REQUIRE_MATCHING_OBJECT( voter( "bob111111111", core_sym::from_string("11.1111") ), get_voter_info( "bob111111111" ) );
 
-   BOOST_REQUIRE_EQUAL( get_global_state()["total_producer_vote_weight"].as<double>(), get_producer_info( "alice1111111" )["total_votes"].as_double() );
+   BOOST_REQUIRE_EQUAL( get_global_state()["total_producer_vote_weight"].as<double>(), get_pending_producer_info( "alice1111111" )["total_votes"].as_double() );
 
 	auto total = get_total_stake("bob111111111");
    //bob111111111 votes for alice1111111
    BOOST_REQUIRE_EQUAL( success(), vote( N(bob111111111), { N(alice1111111) } ) );
 
    //check that producer parameters stay the same after voting
-   prod = get_producer_info( "alice1111111" );
+   prod = get_pending_producer_info( "alice1111111" );
    BOOST_TEST( stake2votes(core_sym::from_string("11.1111"), 1, 1) == prod["total_votes"].as_double() );
    BOOST_REQUIRE_EQUAL( "alice1111111", prod["owner"].as_string() );
    BOOST_REQUIRE_EQUAL( "http://block.one", prod["url"].as_string() );
-   BOOST_REQUIRE_EQUAL( get_global_state()["total_producer_vote_weight"].as<double>(), get_producer_info( "alice1111111" )["total_votes"].as_double() );
+   BOOST_REQUIRE_EQUAL( get_global_state()["total_producer_vote_weight"].as<double>(), get_pending_producer_info( "alice1111111" )["total_votes"].as_double() );
 
    //carol1111111 makes stake
    BOOST_REQUIRE_EQUAL( success(), stake( "carol1111111", core_sym::from_string("22.0000"), core_sym::from_string("0.2222") ) );
@@ -1134,16 +1134,16 @@ BOOST_FIXTURE_TEST_CASE( vote_for_producer, eosio_system_tester, * boost::unit_t
    BOOST_REQUIRE_EQUAL( success(), vote( N(carol1111111), { N(alice1111111) } ) );
 
    //new stake votes be added to alice1111111's total_votes
-   prod = get_producer_info( "alice1111111" );
+   prod = get_pending_producer_info( "alice1111111" );
    BOOST_TEST( stake2votes(core_sym::from_string("22.2222"), 1, 1) + stake2votes(core_sym::from_string("11.1111"), 1, 1) == prod["total_votes"].as_double() );
-   BOOST_REQUIRE_EQUAL( get_global_state()["total_producer_vote_weight"].as<double>(), get_producer_info( "alice1111111" )["total_votes"].as_double() );
+   BOOST_REQUIRE_EQUAL( get_global_state()["total_producer_vote_weight"].as<double>(), get_pending_producer_info( "alice1111111" )["total_votes"].as_double() );
 
    //bob111111111 increases his stake
    BOOST_REQUIRE_EQUAL( success(), stake( "bob111111111", core_sym::from_string("33.0000"), core_sym::from_string("0.3333") ) );
 
-   prod = get_producer_info( "alice1111111" );
+   prod = get_pending_producer_info( "alice1111111" );
    BOOST_TEST( stake2votes(core_sym::from_string("22.2222"), 1, 1) + stake2votes(core_sym::from_string("44.4444"), 1, 1) == prod["total_votes"].as_double() );
-   BOOST_REQUIRE_EQUAL( get_global_state()["total_producer_vote_weight"].as<double>(), get_producer_info( "alice1111111" )["total_votes"].as_double() );
+   BOOST_REQUIRE_EQUAL( get_global_state()["total_producer_vote_weight"].as<double>(), get_pending_producer_info( "alice1111111" )["total_votes"].as_double() );
 
 	total = get_total_stake("bob111111111");
 
@@ -1154,9 +1154,9 @@ BOOST_FIXTURE_TEST_CASE( vote_for_producer, eosio_system_tester, * boost::unit_t
 	total = get_total_stake("carol1111111");
 
    //should increase alice1111111's total_votes
-   prod = get_producer_info( "alice1111111" );
+   prod = get_pending_producer_info( "alice1111111" );
    BOOST_TEST( stake2votes(core_sym::from_string("22.2222"), 1, 1) + stake2votes(core_sym::from_string("66.6666"), 1, 1) == prod["total_votes"].as_double() );
-   BOOST_REQUIRE_EQUAL( get_global_state()["total_producer_vote_weight"].as<double>(), get_producer_info( "alice1111111" )["total_votes"].as_double() );
+   BOOST_REQUIRE_EQUAL( get_global_state()["total_producer_vote_weight"].as<double>(), get_pending_producer_info( "alice1111111" )["total_votes"].as_double() );
 
    //carol1111111 unstakes part of the stake
    BOOST_REQUIRE_EQUAL( success(), unstake( "carol1111111", core_sym::from_string("2.0000"), core_sym::from_string("0.0002")/*"2.0000 EOS", "0.0002 EOS"*/ ) );
@@ -1164,10 +1164,10 @@ BOOST_FIXTURE_TEST_CASE( vote_for_producer, eosio_system_tester, * boost::unit_t
 	total = get_total_stake("carol1111111");
 
    //should decrease alice1111111's total_votes
-   prod = get_producer_info( "alice1111111" );
+   prod = get_pending_producer_info( "alice1111111" );
    wdump((prod));
    BOOST_TEST( stake2votes(core_sym::from_string("20.2220"), 1, 1) + stake2votes(core_sym::from_string("66.6666"), 1, 1) == prod["total_votes"].as_double() );
-   BOOST_REQUIRE_EQUAL( get_global_state()["total_producer_vote_weight"].as<double>(), get_producer_info( "alice1111111" )["total_votes"].as_double() );
+   BOOST_REQUIRE_EQUAL( get_global_state()["total_producer_vote_weight"].as<double>(), get_pending_producer_info( "alice1111111" )["total_votes"].as_double() );
 
    //bob111111111 revokes his vote
    BOOST_REQUIRE_EQUAL( success(), vote( N(bob111111111), vector<account_name>() ) );
@@ -1176,9 +1176,9 @@ BOOST_FIXTURE_TEST_CASE( vote_for_producer, eosio_system_tester, * boost::unit_t
    total = get_total_stake("alice1111111");
 
    //should decrease alice1111111's total_votes
-   prod = get_producer_info( "alice1111111" );
+   prod = get_pending_producer_info( "alice1111111" );
    BOOST_TEST( stake2votes(core_sym::from_string("20.2220"), 1, 1) == prod["total_votes"].as_double() );
-   BOOST_REQUIRE_EQUAL( get_global_state()["total_producer_vote_weight"].as<double>(), get_producer_info( "alice1111111" )["total_votes"].as_double() );
+   BOOST_REQUIRE_EQUAL( get_global_state()["total_producer_vote_weight"].as<double>(), get_pending_producer_info( "alice1111111" )["total_votes"].as_double() );
 
    //but eos should still be at stake
    BOOST_REQUIRE_EQUAL( core_sym::from_string("1955.5556"), get_balance( "bob111111111" ) );
@@ -1189,9 +1189,9 @@ BOOST_FIXTURE_TEST_CASE( vote_for_producer, eosio_system_tester, * boost::unit_t
 	total = get_total_stake("carol1111111");
 
    //should decrease alice1111111's total_votes to zero
-   prod = get_producer_info( "alice1111111" );
+   prod = get_pending_producer_info( "alice1111111" );
    BOOST_TEST( 0.0 == prod["total_votes"].as_double() );
-   BOOST_TEST( get_global_state()["total_producer_vote_weight"].as<double>() == get_producer_info( "alice1111111" )["total_votes"].as_double() );
+   BOOST_TEST( get_global_state()["total_producer_vote_weight"].as<double>() == get_pending_producer_info( "alice1111111" )["total_votes"].as_double() );
 
    //carol1111111 should receive funds in 3 days
    produce_block( fc::days(3) );
@@ -1226,7 +1226,7 @@ BOOST_FIXTURE_TEST_CASE( unregistered_producer_voting, eosio_system_tester, * bo
                         )
    );
    //key should be empty
-   auto prod = get_producer_info( "alice1111111" );
+   auto prod = get_pending_producer_info( "alice1111111" );
    BOOST_REQUIRE_EQUAL( fc::crypto::public_key(), fc::crypto::public_key(prod["producer_key"].as_string()) );
 
    //bob111111111 should not be able to vote for alice1111111 who is an unregistered producer
@@ -1268,7 +1268,7 @@ BOOST_FIXTURE_TEST_CASE( vote_same_producer_30_times, eosio_system_tester ) try
    BOOST_REQUIRE_EQUAL( wasm_assert_msg( "producer votes must be unique and sorted" ),
                         vote( N(bob111111111), vector<account_name>(30, N(alice1111111)) ) );
 
-   auto prod = get_producer_info( "alice1111111" );
+   auto prod = get_pending_producer_info( "alice1111111" );
    BOOST_TEST_REQUIRE( 0 == prod["total_votes"].as_double() );
 
 } FC_LOG_AND_RETHROW()
@@ -1294,7 +1294,7 @@ BOOST_FIXTURE_TEST_CASE( producer_keep_votes, eosio_system_tester, * boost::unit
    //bob111111111 votes for alice1111111
    BOOST_REQUIRE_EQUAL( success(), vote(N(bob111111111), { N(alice1111111) } ) );
 
-   auto prod = get_producer_info( "alice1111111" );
+   auto prod = get_pending_producer_info( "alice1111111" );
    BOOST_TEST_REQUIRE( stake2votes(core_sym::from_string("13.5791"), 1, 1) == prod["total_votes"].as_double() );
 
    //unregister producer
@@ -1302,7 +1302,7 @@ BOOST_FIXTURE_TEST_CASE( producer_keep_votes, eosio_system_tester, * boost::unit
                                                ("producer",  "alice1111111")
                         )
    );
-   prod = get_producer_info( "alice1111111" );
+   prod = get_pending_producer_info( "alice1111111" );
    //key should be empty
    BOOST_REQUIRE_EQUAL( fc::crypto::public_key(), fc::crypto::public_key(prod["producer_key"].as_string()) );
    //check parameters just in case
@@ -1319,7 +1319,7 @@ BOOST_FIXTURE_TEST_CASE( producer_keep_votes, eosio_system_tester, * boost::unit
                                                ("location", 0)
                         )
    );
-   prod = get_producer_info( "alice1111111" );
+   prod = get_pending_producer_info( "alice1111111" );
    //votes should stay the same
    BOOST_TEST_REQUIRE( stake2votes(core_sym::from_string("13.5791"), 1, 1), prod["total_votes"].as_double() );
 
@@ -1332,7 +1332,7 @@ BOOST_FIXTURE_TEST_CASE( producer_keep_votes, eosio_system_tester, * boost::unit
                                                ("location", 0)
                         )
    );
-   prod = get_producer_info( "alice1111111" );
+   prod = get_pending_producer_info( "alice1111111" );
    //votes should stay the same
    BOOST_TEST_REQUIRE( stake2votes(core_sym::from_string("13.5791"), 1, 1), prod["total_votes"].as_double() );
    //check parameters just in case
@@ -1368,17 +1368,17 @@ BOOST_FIXTURE_TEST_CASE( vote_for_two_producers, eosio_system_tester, * boost::u
    BOOST_REQUIRE_EQUAL( success(), stake( "carol1111111", core_sym::from_string("15.0005"), core_sym::from_string("5.0000") ) );
    BOOST_REQUIRE_EQUAL( success(), vote( N(carol1111111), { N(alice1111111), N(bob111111111) } ) );
 
-   auto alice_info = get_producer_info( "alice1111111" );
+   auto alice_info = get_pending_producer_info( "alice1111111" );
    BOOST_TEST( stake2votes(core_sym::from_string("20.0005"), 2, 2) == alice_info["total_votes"].as_double() );
-   auto bob_info = get_producer_info( "bob111111111" );
+   auto bob_info = get_pending_producer_info( "bob111111111" );
    BOOST_TEST( stake2votes(core_sym::from_string("20.0005"), 2, 2) == bob_info["total_votes"].as_double() );
 
    //carol1111111 votes for alice1111111 (but revokes vote for bob111111111)
    BOOST_REQUIRE_EQUAL( success(), vote( N(carol1111111), { N(alice1111111) } ) );
 
-   alice_info = get_producer_info( "alice1111111" );
+   alice_info = get_pending_producer_info( "alice1111111" );
    BOOST_TEST( stake2votes(core_sym::from_string("20.0005"), 1, 2) == alice_info["total_votes"].as_double() );
-   bob_info = get_producer_info( "bob111111111" );
+   bob_info = get_pending_producer_info( "bob111111111" );
    BOOST_TEST( 0 == bob_info["total_votes"].as_double() );
 
    //alice1111111 votes for herself and bob111111111
@@ -1386,10 +1386,10 @@ BOOST_FIXTURE_TEST_CASE( vote_for_two_producers, eosio_system_tester, * boost::u
    BOOST_REQUIRE_EQUAL( success(), stake( "alice1111111", core_sym::from_string("1.0000"), core_sym::from_string("1.0000") ) );
    BOOST_REQUIRE_EQUAL( success(), vote(N(alice1111111), { N(alice1111111), N(bob111111111) } ) );
 
-   alice_info = get_producer_info( "alice1111111" );
+   alice_info = get_pending_producer_info( "alice1111111" );
    BOOST_TEST( stake2votes(core_sym::from_string("20.0005"), 1, 2) + stake2votes(core_sym::from_string("2.0000"), 2, 2) == alice_info["total_votes"].as_double() );
 
-   bob_info = get_producer_info( "bob111111111" );
+   bob_info = get_pending_producer_info( "bob111111111" );
    BOOST_TEST( stake2votes(core_sym::from_string("2.0000"), 2, 2) == bob_info["total_votes"].as_double() );
 
 } FC_LOG_AND_RETHROW()
@@ -1506,15 +1506,15 @@ BOOST_FIXTURE_TEST_CASE( proxy_actions_affect_producers, eosio_system_tester, *
 
    //vote for producers
    BOOST_REQUIRE_EQUAL( success(), vote(N(alice1111111), { N(defproducer1), N(defproducer2) } ) );
-   BOOST_TEST_REQUIRE( stake2votes(core_sym::from_string("150.0003"), 2, 3) == get_producer_info( "defproducer1" )["total_votes"].as_double() );
-   BOOST_TEST_REQUIRE( stake2votes(core_sym::from_string("150.0003"), 2, 3) == get_producer_info( "defproducer2" )["total_votes"].as_double() );
-   BOOST_TEST_REQUIRE( 0 == get_producer_info( "defproducer3" )["total_votes"].as_double() );
+   BOOST_TEST_REQUIRE( stake2votes(core_sym::from_string("150.0003"), 2, 3) == get_pending_producer_info( "defproducer1" )["total_votes"].as_double() );
+   BOOST_TEST_REQUIRE( stake2votes(core_sym::from_string("150.0003"), 2, 3) == get_pending_producer_info( "defproducer2" )["total_votes"].as_double() );
+   BOOST_TEST_REQUIRE( 0 == get_pending_producer_info( "defproducer3" )["total_votes"].as_double() );
 
    //vote for another producers
    BOOST_REQUIRE_EQUAL( success(), vote( N(alice1111111), { N(defproducer1), N(defproducer3) } ) );
-   BOOST_TEST_REQUIRE( stake2votes(core_sym::from_string("150.0003"), 2, 3) == get_producer_info( "defproducer1" )["total_votes"].as_double() );
-   BOOST_REQUIRE_EQUAL( 0, get_producer_info( "defproducer2" )["total_votes"].as_double() );
-   BOOST_TEST_REQUIRE( stake2votes(core_sym::from_string("150.0003"), 2, 3) == get_producer_info( "defproducer3" )["total_votes"].as_double() );
+   BOOST_TEST_REQUIRE( stake2votes(core_sym::from_string("150.0003"), 2, 3) == get_pending_producer_info( "defproducer1" )["total_votes"].as_double() );
+   BOOST_REQUIRE_EQUAL( 0, get_pending_producer_info( "defproducer2" )["total_votes"].as_double() );
+   BOOST_TEST_REQUIRE( stake2votes(core_sym::from_string("150.0003"), 2, 3) == get_pending_producer_info( "defproducer3" )["total_votes"].as_double() );
 
    //unregister proxy
    BOOST_REQUIRE_EQUAL( success(), push_action( N(alice1111111), N(regproxy), mvo()
@@ -1523,9 +1523,9 @@ BOOST_FIXTURE_TEST_CASE( proxy_actions_affect_producers, eosio_system_tester, *
                         )
    );
    //REQUIRE_MATCHING_OBJECT( voter( "alice1111111" )( "proxied_vote_weight", stake2votes(core_sym::from_string("150.0003")) ), get_voter_info( "alice1111111" ) );
-   BOOST_REQUIRE_EQUAL( 0, get_producer_info( "defproducer1" )["total_votes"].as_double() );
-   BOOST_REQUIRE_EQUAL( 0, get_producer_info( "defproducer2" )["total_votes"].as_double() );
-   BOOST_REQUIRE_EQUAL( 0, get_producer_info( "defproducer3" )["total_votes"].as_double() );
+   BOOST_REQUIRE_EQUAL( 0, get_pending_producer_info( "defproducer1" )["total_votes"].as_double() );
+   BOOST_REQUIRE_EQUAL( 0, get_pending_producer_info( "defproducer2" )["total_votes"].as_double() );
+   BOOST_REQUIRE_EQUAL( 0, get_pending_producer_info( "defproducer3" )["total_votes"].as_double() );
 
    //register proxy again
    BOOST_REQUIRE_EQUAL( success(), push_action( N(alice1111111), N(regproxy), mvo()
@@ -1533,22 +1533,22 @@ BOOST_FIXTURE_TEST_CASE( proxy_actions_affect_producers, eosio_system_tester, *
                                                 ("isproxy", true)
                         )
    );
-   BOOST_TEST_REQUIRE( stake2votes(core_sym::from_string("150.0003"), 2, 3) == get_producer_info( "defproducer1" )["total_votes"].as_double() );
-   BOOST_REQUIRE_EQUAL( 0, get_producer_info( "defproducer2" )["total_votes"].as_double() );
-   BOOST_TEST_REQUIRE( stake2votes(core_sym::from_string("150.0003"), 2, 3) == get_producer_info( "defproducer3" )["total_votes"].as_double() );
+   BOOST_TEST_REQUIRE( stake2votes(core_sym::from_string("150.0003"), 2, 3) == get_pending_producer_info( "defproducer1" )["total_votes"].as_double() );
+   BOOST_REQUIRE_EQUAL( 0, get_pending_producer_info( "defproducer2" )["total_votes"].as_double() );
+   BOOST_TEST_REQUIRE( stake2votes(core_sym::from_string("150.0003"), 2, 3) == get_pending_producer_info( "defproducer3" )["total_votes"].as_double() );
 
    //stake increase by proxy itself affects producers
    issue_and_transfer( "alice1111111", core_sym::from_string("1000.0000"),  config::system_account_name );
    BOOST_REQUIRE_EQUAL( success(), stake( "alice1111111", core_sym::from_string("30.0001"), core_sym::from_string("20.0001") ) );
-   BOOST_REQUIRE_EQUAL( stake2votes(core_sym::from_string("200.0005"), 2, 3), get_producer_info( "defproducer1" )["total_votes"].as_double() );
-   BOOST_REQUIRE_EQUAL( 0, get_producer_info( "defproducer2" )["total_votes"].as_double() );
-   BOOST_REQUIRE_EQUAL( stake2votes(core_sym::from_string("200.0005"), 2, 3), get_producer_info( "defproducer3" )["total_votes"].as_double() );
+   BOOST_REQUIRE_EQUAL( stake2votes(core_sym::from_string("200.0005"), 2, 3), get_pending_producer_info( "defproducer1" )["total_votes"].as_double() );
+   BOOST_REQUIRE_EQUAL( 0, get_pending_producer_info( "defproducer2" )["total_votes"].as_double() );
+   BOOST_REQUIRE_EQUAL( stake2votes(core_sym::from_string("200.0005"), 2, 3), get_pending_producer_info( "defproducer3" )["total_votes"].as_double() );
 
    //stake decrease by proxy itself affects producers
    BOOST_REQUIRE_EQUAL( success(), unstake( "alice1111111", core_sym::from_string("10.0001"), core_sym::from_string("10.0001") ) );
-   BOOST_TEST_REQUIRE( stake2votes(core_sym::from_string("180.0003"), 2, 3) == get_producer_info( "defproducer1" )["total_votes"].as_double() );
-   BOOST_REQUIRE_EQUAL( 0, get_producer_info( "defproducer2" )["total_votes"].as_double() );
-   BOOST_TEST_REQUIRE( stake2votes(core_sym::from_string("180.0003"), 2, 3) == get_producer_info( "defproducer3" )["total_votes"].as_double() );
+   BOOST_TEST_REQUIRE( stake2votes(core_sym::from_string("180.0003"), 2, 3) == get_pending_producer_info( "defproducer1" )["total_votes"].as_double() );
+   BOOST_REQUIRE_EQUAL( 0, get_pending_producer_info( "defproducer2" )["total_votes"].as_double() );
+   BOOST_TEST_REQUIRE( stake2votes(core_sym::from_string("180.0003"), 2, 3) == get_pending_producer_info( "defproducer3" )["total_votes"].as_double() );
 
 } FC_LOG_AND_RETHROW()
 
@@ -1565,7 +1565,7 @@ BOOST_FIXTURE_TEST_CASE(producer_pay, eosio_system_tester, * boost::unit_test::t
    create_account_with_resources( N(producvoterb), config::system_account_name, core_sym::from_string("1.0000"), false, large_asset, large_asset );
 
    BOOST_REQUIRE_EQUAL(success(), regproducer(N(defproducera)));
-   auto prod = get_producer_info( N(defproducera) );
+   auto prod = get_pending_producer_info( N(defproducera) );
    BOOST_REQUIRE_EQUAL("defproducera", prod["owner"].as_string());
    BOOST_REQUIRE_EQUAL(0, prod["total_votes"].as_double());                                                                               
 
@@ -1589,7 +1589,7 @@ BOOST_FIXTURE_TEST_CASE(producer_pay, eosio_system_tester, * boost::unit_test::t
       const int64_t  initial_savings           = get_balance(N(eosio.saving)).get_amount();
       const uint32_t initial_tot_unpaid_blocks = initial_global_state["total_unpaid_blocks"].as<uint32_t>();
       
-      prod = get_producer_info("defproducera");
+      prod = get_pending_producer_info("defproducera");
       const uint32_t unpaid_blocks = prod["unpaid_blocks"].as<uint32_t>();
       const bool is_active = prod["is_active"].as<bool>();
       
@@ -1628,12 +1628,14 @@ BOOST_FIXTURE_TEST_CASE(producer_pay, eosio_system_tester, * boost::unit_test::t
       auto to_workers = static_cast<int64_t>((12 * double(worker_amount) * double(usecs_between_fills)) / double(usecs_per_year));
       auto to_producers = static_cast<int64_t>((bpay_rate_percent * double(initial_supply.get_amount()) * double(usecs_between_fills)) / double(usecs_per_year));
 
-      prod = get_producer_info("defproducera");
+      prod = get_pending_producer_info("defproducera");
       asset to_bpay = asset(to_producers, symbol{CORE_SYM});
       asset to_wps = asset(to_workers, symbol{CORE_SYM});
       asset new_tokens = asset(to_workers + to_producers, symbol{CORE_SYM});
       
-      BOOST_REQUIRE_EQUAL(0, prod["unpaid_blocks"].as<uint32_t>());
+      //the snapshot folded the blocks of the closed window, including its own, into the producer row
+      BOOST_REQUIRE_EQUAL(unpaid_blocks + 1, get_producer_info("defproducera")["unpaid_blocks"].as<uint32_t>());
+      BOOST_REQUIRE_EQUAL(unpaid_blocks + 1, prod["unpaid_blocks"].as<uint32_t>());
       BOOST_REQUIRE_EQUAL(0, tot_unpaid_blocks);
       BOOST_REQUIRE_EQUAL(get_balance(N(eosio.bpay)), initial_bpay_balance + to_bpay);
       BOOST_REQUIRE_EQUAL(get_balance(N(eosio.saving)), initial_wps_balance + to_wps);
@@ -1647,12 +1649,48 @@ BOOST_FIXTURE_TEST_CASE(producer_pay, eosio_system_tester, * boost::unit_test::t
       push_action(N(defproducera), N(claimrewards), mvo()("owner", "defproducera"));
 
       BOOST_REQUIRE_EQUAL(get_balance(N(defproducera)), initial_prod_balance + payment);
+      prod = get_pending_producer_info("defproducera");
       BOOST_REQUIRE_EQUAL(claim_time, microseconds_since_epoch_of_iso_string( prod["last_claim_time"] ));
+      BOOST_REQUIRE_EQUAL(0, get_producer_info("defproducera")["unpaid_blocks"].as<uint32_t>());
+      BOOST_REQUIRE_EQUAL(unpaid_blocks + 1, get_producer_info("defproducera")["lifetime_produced_blocks"].as<uint32_t>());
 
       BOOST_REQUIRE(get_payment_info(N(defproducera)).is_null());
+
+      // the snapshot only raised the reward index, the claim moved the producer to it
+      const fc::variant reward_index = abi_ser.binary_to_variant( "reward_index_state",
+         get_row_by_account( config::system_account_name, config::system_account_name, N(rewardindex), N(rewardindex) ), abi_serializer_max_time );
+      const fc::variant reward = abi_ser.binary_to_variant( "producer_reward",
+         get_row_by_account( config::system_account_name, config::system_account_name, N(prodrewards), N(defproducera) ), abi_serializer_max_time );
+      BOOST_REQUIRE_EQUAL(payment.get_amount() / 2, reward_index["pay_per_share"].as<int64_t>());
+      BOOST_REQUIRE_EQUAL(reward_index["pay_per_share"].as<int64_t>(), reward["pay_index"].as<int64_t>());
+      BOOST_REQUIRE_EQUAL(2, reward["shares"].as<uint32_t>());
+      BOOST_REQUIRE_EQUAL(0, reward["unclaimed"].as<int64_t>());
    }
 } FC_LOG_AND_RETHROW()
 
+BOOST_FIXTURE_TEST_CASE(token_supply_mirror, eosio_system_tester) try {
+   BOOST_REQUIRE( get_token_mirror().is_null() );
+   BOOST_REQUIRE_EQUAL( success(), checksupply( N(alice1111111) ) );
+   BOOST_REQUIRE_EQUAL( get_token_supply(), get_token_mirror()["supply"].as<asset>() );
+
+   //tokens issued outside of the rewards snapshot are followed through the issue notification
+   const asset supply = get_token_supply();
+   issue_and_transfer( "alice1111111", core_sym::from_string("1000.0000"),  config::system_account_name );
+   BOOST_REQUIRE_EQUAL( supply + core_sym::from_string("1000.0000"), get_token_supply() );
+   BOOST_REQUIRE_EQUAL( get_token_supply(), get_token_mirror()["supply"].as<asset>() );
+
+   //and retired tokens through the retire notification
+   base_tester::push_action( N(eosio.token), N(retire), config::system_account_name, mutable_variant_object()
+                             ("quantity", core_sym::from_string("400.0000"))
+                             ("memo",     "")
+                             );
+   BOOST_REQUIRE_EQUAL( supply + core_sym::from_string("600.0000"), get_token_supply() );
+   BOOST_REQUIRE_EQUAL( get_token_supply(), get_token_mirror()["supply"].as<asset>() );
+   BOOST_REQUIRE_EQUAL( success(), checksupply( N(alice1111111) ) );
+   BOOST_REQUIRE_EQUAL( get_token_supply(), get_token_mirror()["supply"].as<asset>() );
+
+} FC_LOG_AND_RETHROW()
+
 BOOST_FIXTURE_TEST_CASE(multi_producer_pay, eosio_system_tester, * boost::unit_test::tolerance(1e-10)) try {
    const double usecs_per_year  = 52 * 7 * 24 * 3600 * 1000000ll;
    const double secs_per_year   = 52 * 7 * 24 * 3600;
@@ -1669,7 +1707,7 @@ BOOST_FIXTURE_TEST_CASE(multi_producer_pay, eosio_system_tester, * boost::unit_t
       setup_producer_accounts(producer_names);
       for ( const auto& p: producer_names ) {
          BOOST_REQUIRE_EQUAL( success(), regproducer(p) );
-         BOOST_TEST_REQUIRE( 0 == get_producer_info(p)["total_votes"].as<double>() );
+         BOOST_TEST_REQUIRE( 0 == get_pending_producer_info(p)["total_votes"].as<double>() );
       }
       std::sort(producer_names.begin(), producer_names.end());
    }
@@ -1679,7 +1717,7 @@ BOOST_FIXTURE_TEST_CASE(multi_producer_pay, eosio_system_tester, * boost::unit_t
    create_account_with_resources( N(producvotera), config::system_account_name, core_sym::from_string("1.0000"), false, large_asset, large_asset );
    create_account_with_resources( N(producvoterb), config::system_account_name, core_sym::from_string("1.0000"), false, large_asset, large_asset );                                                                            
 
-   auto prod = get_producer_info(producer_names[0]);
+   auto prod = get_pending_producer_info(producer_names[0]);
    BOOST_REQUIRE_EQUAL(producer_names[0], prod["owner"].as_string());
    BOOST_REQUIRE_EQUAL(0, prod["total_votes"].as_double());
    // TODO: INCREASE VOTER As stake
@@ -1747,7 +1785,7 @@ BOOST_FIXTURE_TEST_CASE(multi_producer_pay, eosio_system_tester, * boost::unit_t
 
       vector<fc::variant> producer_infos;
       for(const name &p : producer_names) {
-         producer_infos.emplace_back(get_producer_info(p));
+         producer_infos.emplace_back(get_pending_producer_info(p));
          // cout << "producer pay info: " << get_payment_info(p) << endl << endl;
       }
 
@@ -1774,11 +1812,12 @@ BOOST_FIXTURE_TEST_CASE(multi_producer_pay, eosio_system_tester, * boost::unit_t
       auto shareValue = to_producers / sharecount;
 
       int producer_count = 0;
+      uint32_t folded_unpaid_blocks = 0;
       for(const auto &prod : producer_infos) {
          // cout << producer_count << endl;
          // cout << "producer_info: " << prod << endl;
          if(producer_count < 51) {
-            BOOST_REQUIRE_EQUAL(0, prod["unpaid_blocks"].as<uint32_t>());
+            folded_unpaid_blocks += get_producer_info(prod["owner"].as<name>())["unpaid_blocks"].as<uint32_t>();
             const asset balance = get_balance(prod["owner"].as<name>());
             const fc::variant payout_info = get_payment_info(prod["owner"].as<name>());
             BOOST_REQUIRE(!payout_info.is_null());
@@ -1787,7 +1826,8 @@ BOOST_FIXTURE_TEST_CASE(multi_producer_pay, eosio_system_tester, * boost::unit_t
             BOOST_REQUIRE_EQUAL(payment, asset(shareValue * ((producer_count < 21) ? 2 : 1), symbol{CORE_SYM}));
             push_action(prod["owner"].as<name>(), N(claimrewards), mvo()("owner", prod["owner"].as<name>()));
             BOOST_REQUIRE_EQUAL(get_balance(prod["owner"].as<name>()), balance + payment);
-            BOOST_REQUIRE_EQUAL(claim_time, microseconds_since_epoch_of_iso_string( prod["last_claim_time"] ));
+            BOOST_REQUIRE_EQUAL(claim_time, microseconds_since_epoch_of_iso_string( get_pending_producer_info(prod["owner"].as<name>())["last_claim_time"] ));
+            BOOST_REQUIRE_EQUAL(0, get_producer_info(prod["owner"].as<name>())["unpaid_blocks"].as<uint32_t>());
          } else {
             BOOST_REQUIRE_EQUAL(0, prod["unpaid_blocks"].as<uint32_t>());
             const asset balance = get_balance(prod["owner"].as<name>());
@@ -1800,6 +1840,8 @@ BOOST_FIXTURE_TEST_CASE(multi_producer_pay, eosio_system_tester, * boost::unit_t
       }
 
       BOOST_REQUIRE_EQUAL(0, tot_unpaid_blocks);
+      //the snapshot folded every block of the closed window, including its own, into the producer rows
+      BOOST_REQUIRE_EQUAL(initial_tot_unpaid_blocks + 1, folded_unpaid_blocks);
       
       BOOST_REQUIRE_EQUAL(get_balance(N(eosio.saving)), initial_wps_balance + to_wps);
       const asset supply  = get_token_supply();
@@ -1952,8 +1994,8 @@ BOOST_FIXTURE_TEST_CASE(producer_onblock_check, eosio_system_tester) try {
    for (auto a:producer_names)
       regproducer(a);
 
-   BOOST_REQUIRE_EQUAL(0, get_producer_info( producer_names.front() )["total_votes"].as<double>());
-   BOOST_REQUIRE_EQUAL(0, get_producer_info( producer_names.back() )["total_votes"].as<double>());
+   BOOST_REQUIRE_EQUAL(0, get_pending_producer_info( producer_names.front() )["total_votes"].as<double>());
+   BOOST_REQUIRE_EQUAL(0, get_pending_producer_info( producer_names.back() )["total_votes"].as<double>());
 
    transfer(config::system_account_name, "producvotera", half_min_activated_stake, config::system_account_name);
    BOOST_REQUIRE_EQUAL(success(), stake("producvotera", quarter_min_activated_stake, quarter_min_activated_stake ));
@@ -1968,13 +2010,13 @@ BOOST_FIXTURE_TEST_CASE(producer_onblock_check, eosio_system_tester) try {
 
       bool all_21_produced = true;
       for (uint32_t i = 0; i < 21; ++i) {
-         if (0 == get_producer_info(producer_names[i])["unpaid_blocks"].as<uint32_t>()) {
+         if (0 == get_pending_producer_info(producer_names[i])["unpaid_blocks"].as<uint32_t>()) {
             all_21_produced= false;
          }
       }
       bool rest_didnt_produce = true;
       for (uint32_t i = 21; i < producer_names.size(); ++i) {
-         if (0 < get_producer_info(producer_names[i])["unpaid_blocks"].as<uint32_t>()) {
+         if (0 < get_pending_producer_info(producer_names[i])["unpaid_blocks"].as<uint32_t>()) {
             rest_didnt_produce = false;
          }
       }
@@ -2010,18 +2052,18 @@ BOOST_FIXTURE_TEST_CASE(producer_onblock_check, eosio_system_tester) try {
    {
       produce_blocks(21 * 12);
       for (uint32_t i = 0; i < producer_names.size(); ++i) {
-         std::cout<<"["<<producer_names[i]<<"]: "<<get_producer_info(producer_names[i])["unpaid_blocks"].as<uint32_t>()<<std::endl;
+         std::cout<<"["<<producer_names[i]<<"]: "<<get_pending_producer_info(producer_names[i])["unpaid_blocks"].as<uint32_t>()<<std::endl;
       }
 
-      bool all_21_produced = 0 < get_producer_info(producer_names[21])["unpaid_blocks"].as<uint32_t>();
+      bool all_21_produced = 0 < get_pending_producer_info(producer_names[21])["unpaid_blocks"].as<uint32_t>();
       for (uint32_t i = 1; i < 21; ++i) {
-         if (0 == get_producer_info(producer_names[i])["unpaid_blocks"].as<uint32_t>()) {
+         if (0 == get_pending_producer_info(producer_names[i])["unpaid_blocks"].as<uint32_t>()) {
             all_21_produced= false;
          }
       }
-      bool rest_didnt_produce = 0 == get_producer_info(producer_names[0])["unpaid_blocks"].as<uint32_t>();
+      bool rest_didnt_produce = 0 == get_pending_producer_info(producer_names[0])["unpaid_blocks"].as<uint32_t>();
       for (uint32_t i = 22; i < producer_names.size(); ++i) {
-         if (0 < get_producer_info(producer_names[i])["unpaid_blocks"].as<uint32_t>()) {
+         if (0 < get_pending_producer_info(producer_names[i])["unpaid_blocks"].as<uint32_t>()) {
             rest_didnt_produce = false;
          }
       }
@@ -2075,9 +2117,9 @@ BOOST_FIXTURE_TEST_CASE( voter_and_proxy_actions_affect_producers_and_totals, eo
    BOOST_REQUIRE_EQUAL( success(), stake( "alice1111111", core_sym::from_string("30.0001"), core_sym::from_string("20.0001") ) );
    BOOST_REQUIRE_EQUAL( success(), vote( N(alice1111111), { N(defproducer1), N(defproducer2) } ) );
    auto expected_value = stake2votes(core_sym::from_string("50.0002"),2,3);
-   BOOST_TEST_REQUIRE( expected_value == get_producer_info( "defproducer1" )["total_votes"].as_double() );
-   BOOST_TEST_REQUIRE( expected_value == get_producer_info( "defproducer2" )["total_votes"].as_double() );
-   BOOST_REQUIRE_EQUAL( 0, get_producer_info( "defproducer3" )["total_votes"].as_double() );
+   BOOST_TEST_REQUIRE( expected_value == get_pending_producer_info( "defproducer1" )["total_votes"].as_double() );
+   BOOST_TEST_REQUIRE( expected_value == get_pending_producer_info( "defproducer2" )["total_votes"].as_double() );
+   BOOST_REQUIRE_EQUAL( 0, get_pending_producer_info( "defproducer3" )["total_votes"].as_double() );
 
    //donald111111 makes bob his proxy
    issue_and_transfer( name("donald111111"), asset(10000000, symbol{CORE_SYM}));
@@ -2089,17 +2131,17 @@ BOOST_FIXTURE_TEST_CASE( voter_and_proxy_actions_affect_producers_and_totals, eo
    BOOST_REQUIRE_EQUAL( success(), stake( "bob111111111", core_sym::from_string("20.0001"), core_sym::from_string("20.0001") ) );
    BOOST_REQUIRE_EQUAL( success(), vote( N(bob111111111), { N(defproducer1), N(defproducer2) } ) );
    expected_value = stake2votes(core_sym::from_string("50.0002"),2,3) * 2;
-   BOOST_TEST_REQUIRE( expected_value == get_producer_info( "defproducer1" )["total_votes"].as_double() );
-   BOOST_TEST_REQUIRE( expected_value == get_producer_info( "defproducer2" )["total_votes"].as_double() );
-   BOOST_REQUIRE_EQUAL( 0, get_producer_info( "defproducer3" )["total_votes"].as_double() );
+   BOOST_TEST_REQUIRE( expected_value == get_pending_producer_info( "defproducer1" )["total_votes"].as_double() );
+   BOOST_TEST_REQUIRE( expected_value == get_pending_producer_info( "defproducer2" )["total_votes"].as_double() );
+   BOOST_REQUIRE_EQUAL( 0, get_pending_producer_info( "defproducer3" )["total_votes"].as_double() );
 
    auto initial_activated_stake = get_global_state()["total_activated_stake"].as_int64();
 
    //donald111111 switches to alice as his proxy
    BOOST_REQUIRE_EQUAL( success(), vote( N(donald111111), vector<account_name>(), "alice1111111" ) );
-   BOOST_TEST_REQUIRE( expected_value == get_producer_info( "defproducer1" )["total_votes"].as_double() );
-   BOOST_TEST_REQUIRE( expected_value == get_producer_info( "defproducer2" )["total_votes"].as_double() );
-   BOOST_REQUIRE_EQUAL( 0, get_producer_info( "defproducer3" )["total_votes"].as_double() );
+   BOOST_TEST_REQUIRE( expected_value == get_pending_producer_info( "defproducer1" )["total_votes"].as_double() );
+   BOOST_TEST_REQUIRE( expected_value == get_pending_producer_info( "defproducer2" )["total_votes"].as_double() );
+   BOOST_REQUIRE_EQUAL( 0, get_pending_producer_info( "defproducer3" )["total_votes"].as_double() );
 
    expected_value = expected_value * 2; // 2 producers with same weight
    BOOST_TEST_REQUIRE(get_global_state()["total_producer_vote_weight"].as_double() == expected_value);
@@ -2128,9 +2170,9 @@ BOOST_FIXTURE_TEST_CASE( voters_actions_affect_proxy_and_producers, eosio_system
    issue_and_transfer( "alice1111111", core_sym::from_string("1000.0000"),  config::system_account_name );
    BOOST_REQUIRE_EQUAL( success(), stake( "alice1111111", core_sym::from_string("30.0001"), core_sym::from_string("20.0001") ) );
    BOOST_REQUIRE_EQUAL( success(), vote( N(alice1111111), { N(defproducer1), N(defproducer2) } ) );
-   BOOST_TEST_REQUIRE( stake2votes(core_sym::from_string("50.0002"),2,3) == get_producer_info( "defproducer1" )["total_votes"].as_double() );
-   BOOST_TEST_REQUIRE( stake2votes(core_sym::from_string("50.0002"),2,3) == get_producer_info( "defproducer2" )["total_votes"].as_double() );
-   BOOST_REQUIRE_EQUAL( 0, get_producer_info( "defproducer3" )["total_votes"].as_double() );
+   BOOST_TEST_REQUIRE( stake2votes(core_sym::from_string("50.0002"),2,3) == get_pending_producer_info( "defproducer1" )["total_votes"].as_double() );
+   BOOST_TEST_REQUIRE( stake2votes(core_sym::from_string("50.0002"),2,3) == get_pending_producer_info( "defproducer2" )["total_votes"].as_double() );
+   BOOST_REQUIRE_EQUAL( 0, get_pending_producer_info( "defproducer3" )["total_votes"].as_double() );
 
    BOOST_REQUIRE_EQUAL( success(), push_action( N(donald111111), N(regproxy), mvo()
                                                 ("proxy",  "donald111111")
@@ -2144,47 +2186,47 @@ BOOST_FIXTURE_TEST_CASE( voters_actions_affect_proxy_and_producers, eosio_system
    BOOST_REQUIRE_EQUAL( success(), stake( "bob111111111", core_sym::from_string("100.0002"), core_sym::from_string("50.0001") ) );
    BOOST_REQUIRE_EQUAL( success(), vote( N(bob111111111), vector<account_name>(), "alice1111111" ) );
    BOOST_TEST_REQUIRE( 1500003 == get_voter_info( "alice1111111" )["proxied_vote_weight"].as_double() );
-   BOOST_TEST_REQUIRE( stake2votes(core_sym::from_string("200.0005"),2,3) == get_producer_info( "defproducer1" )["total_votes"].as_double() );
-   BOOST_TEST_REQUIRE( stake2votes(core_sym::from_string("200.0005"),2,3) == get_producer_info( "defproducer2" )["total_votes"].as_double() );
-   BOOST_REQUIRE_EQUAL( 0, get_producer_info( "defproducer3" )["total_votes"].as_double() );
+   BOOST_TEST_REQUIRE( stake2votes(core_sym::from_string("200.0005"),2,3) == get_pending_producer_info( "defproducer1" )["total_votes"].as_double() );
+   BOOST_TEST_REQUIRE( stake2votes(core_sym::from_string("200.0005"),2,3) == get_pending_producer_info( "defproducer2" )["total_votes"].as_double() );
+   BOOST_REQUIRE_EQUAL( 0, get_pending_producer_info( "defproducer3" )["total_votes"].as_double() );
 
    //carol1111111 chooses alice1111111 as a proxy
    issue_and_transfer( "carol1111111", core_sym::from_string("1000.0000"),  config::system_account_name );
    BOOST_REQUIRE_EQUAL( success(), stake( "carol1111111", core_sym::from_string("30.0001"), core_sym::from_string("20.0001") ) );
    BOOST_REQUIRE_EQUAL( success(), vote( N(carol1111111), vector<account_name>(), "alice1111111" ) );
    BOOST_TEST_REQUIRE( 2000005 == get_voter_info( "alice1111111" )["proxied_vote_weight"].as_double() );
-   BOOST_TEST_REQUIRE( stake2votes(core_sym::from_string("250.0007"),2,3) == get_producer_info( "defproducer1" )["total_votes"].as_double() );
-   BOOST_TEST_REQUIRE( stake2votes(core_sym::from_string("250.0007"),2,3) == get_producer_info( "defproducer2" )["total_votes"].as_double() );
-   BOOST_REQUIRE_EQUAL( 0, get_producer_info( "defproducer3" )["total_votes"].as_double() );
+   BOOST_TEST_REQUIRE( stake2votes(core_sym::from_string("250.0007"),2,3) == get_pending_producer_info( "defproducer1" )["total_votes"].as_double() );
+   BOOST_TEST_REQUIRE( stake2votes(core_sym::from_string("250.0007"),2,3) == get_pending_producer_info( "defproducer2" )["total_votes"].as_double() );
+   BOOST_REQUIRE_EQUAL( 0, get_pending_producer_info( "defproducer3" )["total_votes"].as_double() );
 
    //proxied voter carol1111111 increases stake
    BOOST_REQUIRE_EQUAL( success(), stake( "carol1111111", core_sym::from_string("50.0000"), core_sym::from_string("70.0000") ) );
    BOOST_TEST_REQUIRE( 3200005 == get_voter_info( "alice1111111" )["proxied_vote_weight"].as_double() );
-   BOOST_TEST_REQUIRE( stake2votes(core_sym::from_string("370.0007"),2,3) == get_producer_info( "defproducer1" )["total_votes"].as_double() );
-   BOOST_TEST_REQUIRE( stake2votes(core_sym::from_string("370.0007"),2,3) == get_producer_info( "defproducer2" )["total_votes"].as_double() );
-   BOOST_REQUIRE_EQUAL( 0, get_producer_info( "defproducer3" )["total_votes"].as_double() );
+   BOOST_TEST_REQUIRE( stake2votes(core_sym::from_string("370.0007"),2,3) == get_pending_producer_info( "defproducer1" )["total_votes"].as_double() );
+   BOOST_TEST_REQUIRE( stake2votes(core_sym::from_string("370.0007"),2,3) == get_pending_producer_info( "defproducer2" )["total_votes"].as_double() );
+   BOOST_REQUIRE_EQUAL( 0, get_pending_producer_info( "defproducer3" )["total_votes"].as_double() );
 
    //proxied voter bob111111111 decreases stake
    BOOST_REQUIRE_EQUAL( success(), unstake( "bob111111111", core_sym::from_string("50.0001"), core_sym::from_string("50.0001") ) );
    BOOST_TEST_REQUIRE( 2200003 == get_voter_info( "alice1111111" )["proxied_vote_weight"].as_double() );
-   BOOST_TEST_REQUIRE( stake2votes(core_sym::from_string("270.0005"),2,3) == get_producer_info( "defproducer1" )["total_votes"].as_double() );
-   BOOST_TEST_REQUIRE( stake2votes(core_sym::from_string("270.0005"),2,3) == get_producer_info( "defproducer2" )["total_votes"].as_double() );
-   BOOST_REQUIRE_EQUAL( 0, get_producer_info( "defproducer3" )["total_votes"].as_double() );
+   BOOST_TEST_REQUIRE( stake2votes(core_sym::from_string("270.0005"),2,3) == get_pending_producer_info( "defproducer1" )["total_votes"].as_double() );
+   BOOST_TEST_REQUIRE( stake2votes(core_sym::from_string("270.0005"),2,3) == get_pending_producer_info( "defproducer2" )["total_votes"].as_double() );
+   BOOST_REQUIRE_EQUAL( 0, get_pending_producer_info( "defproducer3" )["total_votes"].as_double() );
 
    //proxied voter carol1111111 chooses another proxy
    BOOST_REQUIRE_EQUAL( success(), vote( N(carol1111111), vector<account_name>(), "donald111111" ) );
    BOOST_TEST_REQUIRE( 500001, get_voter_info( "alice1111111" )["proxied_vote_weight"].as_double() );
    BOOST_TEST_REQUIRE( 1700002, get_voter_info( "donald111111" )["proxied_vote_weight"].as_double() );
-   BOOST_TEST_REQUIRE( stake2votes(core_sym::from_string("100.0003"),2,3), get_producer_info( "defproducer1" )["total_votes"].as_double() );
-   BOOST_TEST_REQUIRE( stake2votes(core_sym::from_string("100.0003"),2,3), get_producer_info( "defproducer2" )["total_votes"].as_double() );
-   BOOST_REQUIRE_EQUAL( 0, get_producer_info( "defproducer3" )["total_votes"].as_double() );
+   BOOST_TEST_REQUIRE( stake2votes(core_sym::from_string("100.0003"),2,3), get_pending_producer_info( "defproducer1" )["total_votes"].as_double() );
+   BOOST_TEST_REQUIRE( stake2votes(core_sym::from_string("100.0003"),2,3), get_pending_producer_info( "defproducer2" )["total_votes"].as_double() );
+   BOOST_REQUIRE_EQUAL( 0, get_pending_producer_info( "defproducer3" )["total_votes"].as_double() );
 
    //bob111111111 switches to direct voting and votes for one of the same producers, but not for another one
    BOOST_REQUIRE_EQUAL( success(), vote( N(bob111111111), { N(defproducer2) } ) );
    BOOST_TEST_REQUIRE( 0.0 == get_voter_info( "alice1111111" )["proxied_vote_weight"].as_double() );
-   BOOST_TEST_REQUIRE( stake2votes(core_sym::from_string("50.0002"),2,3), get_producer_info( "defproducer1" )["total_votes"].as_double() );
-   BOOST_TEST_REQUIRE( stake2votes(core_sym::from_string("100.0003"),1,3), get_producer_info( "defproducer2" )["total_votes"].as_double() );
-   BOOST_TEST_REQUIRE( 0.0 == get_producer_info( "defproducer3" )["total_votes"].as_double() );
+   BOOST_TEST_REQUIRE( stake2votes(core_sym::from_string("50.0002"),2,3), get_pending_producer_info( "defproducer1" )["total_votes"].as_double() );
+   BOOST_TEST_REQUIRE( stake2votes(core_sym::from_string("100.0003"),1,3), get_pending_producer_info( "defproducer2" )["total_votes"].as_double() );
+   BOOST_TEST_REQUIRE( 0.0 == get_pending_producer_info( "defproducer3" )["total_votes"].as_double() );
 
 } FC_LOG_AND_RETHROW()
 
@@ -2312,6 +2354,141 @@ BOOST_FIXTURE_TEST_CASE( proxy_cannot_use_another_proxy, eosio_system_tester ) t
 
 } FC_LOG_AND_RETHROW()
 
+BOOST_FIXTURE_TEST_CASE( reconcile_votes_idle, eosio_system_tester ) try {
+   issue_and_transfer( "alice1111111", core_sym::from_string("1000.0000"),  config::system_account_name );
+   BOOST_REQUIRE_EQUAL( success(), stake( "alice1111111", core_sym::from_string("100.0000"), core_sym::from_string("50.0000") ) );
+   BOOST_REQUIRE_EQUAL( success(), regproducer( "alice1111111" ) );
+   BOOST_REQUIRE_EQUAL( success(), vote( N(alice1111111), { N(alice1111111) } ) );
+   produce_blocks( 2 );
+
+   //tallies are consistent, so there is nothing to reconcile
+   BOOST_REQUIRE_EQUAL( false, get_reconcile_state()["active"].as_bool() );
+   BOOST_REQUIRE_EQUAL( wasm_assert_msg( "no vote reconciliation in progress" ), reconvotes( N(alice1111111), 10 ) );
+   BOOST_REQUIRE_EQUAL( wasm_assert_msg( "must replay at least one voter" ), reconvotes( N(alice1111111), 0 ) );
+   BOOST_REQUIRE_EQUAL( error("missing authority of alice1111111"),
+                        push_action( N(bob111111111), N(reconvotes), mvo()("user", "alice1111111")("max", 1) ) );
+
+   BOOST_REQUIRE_EQUAL( get_global_state()["total_producer_vote_weight"].as<double>(), get_pending_producer_info( "alice1111111" )["total_votes"].as_double() );
+
+} FC_LOG_AND_RETHROW()
+
+BOOST_FIXTURE_TEST_CASE( vote_deltas_settle_on_schedule_update, eosio_system_tester ) try {
+   issue_and_transfer( "alice1111111", core_sym::from_string("1000.0000"),  config::system_account_name );
+   BOOST_REQUIRE_EQUAL( success(), stake( "alice1111111", core_sym::from_string("100.0000"), core_sym::from_string("50.0000") ) );
+   BOOST_REQUIRE_EQUAL( success(), regproducer( "alice1111111" ) );
+   BOOST_REQUIRE_EQUAL( success(), vote( N(alice1111111), { N(alice1111111) } ) );
+
+   //the vote is pending, total_votes of the producer row is stale
+   const double total_votes = get_pending_producer_info( "alice1111111" )["total_votes"].as_double();
+   BOOST_REQUIRE( total_votes > 0 );
+   BOOST_REQUIRE_EQUAL( 0, get_producer_info( "alice1111111" )["total_votes"].as_double() );
+   BOOST_REQUIRE( !get_row_by_account( config::system_account_name, config::system_account_name, N(votedeltas), N(alice1111111) ).empty() );
+
+   //it stays stale across blocks until onblock updates the producer schedule
+   produce_blocks( 2 );
+   BOOST_REQUIRE_EQUAL( 0, get_producer_info( "alice1111111" )["total_votes"].as_double() );
+
+   //onblock settles pending votes before ranking producers
+   activate_network();
+   produce_blocks( 2 );
+   BOOST_REQUIRE_EQUAL( total_votes, get_producer_info( "alice1111111" )["total_votes"].as_double() );
+   BOOST_REQUIRE( get_row_by_account( config::system_account_name, config::system_account_name, N(votedeltas), N(alice1111111) ).empty() );
+
+} FC_LOG_AND_RETHROW()
+
+BOOST_FIXTURE_TEST_CASE( rebuild_proxy_from_delegators, eosio_system_tester, * boost::unit_test::tolerance(1e-4) ) try {
+   create_accounts_with_resources( { N(defproducer1) } );
+   BOOST_REQUIRE_EQUAL( success(), regproducer( "defproducer1" ) );
+
+   //alice1111111 becomes a proxy and votes
+   issue_and_transfer( "alice1111111", core_sym::from_string("1000.0000"),  config::system_account_name );
+   BOOST_REQUIRE_EQUAL( success(), stake( "alice1111111", core_sym::from_string("100.0000"), core_sym::from_string("50.0000") ) );
+   BOOST_REQUIRE_EQUAL( success(), push_action( N(alice1111111), N(regproxy), mvo()
+                                                ("proxy",  "alice1111111")
+                                                ("isproxy", true)
+                        )
+   );
+   BOOST_REQUIRE_EQUAL( success(), vote( N(alice1111111), { N(defproducer1) } ) );
+
+   //bob111111111 and carol1111111 delegate to alice1111111
+   issue_and_transfer( "bob111111111", core_sym::from_string("1000.0000"),  config::system_account_name );
+   BOOST_REQUIRE_EQUAL( success(), stake( "bob111111111", core_sym::from_string("20.0000"), core_sym::from_string("10.0000") ) );
+   BOOST_REQUIRE_EQUAL( success(), vote( N(bob111111111), vector<account_name>(), "alice1111111" ) );
+   issue_and_transfer( "carol1111111", core_sym::from_string("1000.0000"),  config::system_account_name );
+   BOOST_REQUIRE_EQUAL( success(), stake( "carol1111111", core_sym::from_string("40.0000"), core_sym::from_string("20.0000") ) );
+   BOOST_REQUIRE_EQUAL( success(), vote( N(carol1111111), vector<account_name>(), "alice1111111" ) );
+   BOOST_REQUIRE( is_delegator( N(alice1111111), N(bob111111111) ) );
+   BOOST_REQUIRE( is_delegator( N(alice1111111), N(carol1111111) ) );
+
+   //rebuilding needs the whole voters table indexed
+   BOOST_REQUIRE_EQUAL( wasm_assert_msg( "delegators are still being indexed" ), rebuildproxy( N(alice1111111) ) );
+   BOOST_REQUIRE_EQUAL( wasm_assert_msg( "must index at least one voter" ), indexproxied( N(bob111111111), 0 ) );
+   BOOST_REQUIRE_EQUAL( success(), indexproxied( N(bob111111111), 100 ) );
+   BOOST_REQUIRE_EQUAL( wasm_assert_msg( "delegators are already indexed" ), indexproxied( N(bob111111111), 100 ) );
+
+   const double proxied = get_voter_info( "alice1111111" )["proxied_vote_weight"].as_double();
+   const double total_votes = get_pending_producer_info( "defproducer1" )["total_votes"].as_double();
+   BOOST_TEST_REQUIRE( proxied == 900000.0 );
+   BOOST_REQUIRE_EQUAL( success(), rebuildproxy( N(alice1111111) ) );
+   BOOST_TEST_REQUIRE( get_voter_info( "alice1111111" )["proxied_vote_weight"].as_double() == proxied );
+   BOOST_TEST_REQUIRE( get_pending_producer_info( "defproducer1" )["total_votes"].as_double() == total_votes );
+
+   //switching away from the proxy removes the delegator
+   BOOST_REQUIRE_EQUAL( success(), vote( N(carol1111111), { N(defproducer1) } ) );
+   BOOST_REQUIRE( !is_delegator( N(alice1111111), N(carol1111111) ) );
+   BOOST_REQUIRE_EQUAL( success(), rebuildproxy( N(alice1111111) ) );
+   BOOST_TEST_REQUIRE( get_voter_info( "alice1111111" )["proxied_vote_weight"].as_double() == 300000.0 );
+
+   BOOST_REQUIRE_EQUAL( wasm_assert_msg( "proxy not found" ), rebuildproxy( N(defproducer2) ) );
+   BOOST_REQUIRE_EQUAL( wasm_assert_msg( "account is not a proxy" ), rebuildproxy( N(bob111111111) ) );
+   //the whole delegators scope is read in one action, only the system account can rebuild
+   BOOST_REQUIRE_EQUAL( error("missing authority of eosio"), rebuildproxy( N(alice1111111), false ) );
+
+} FC_LOG_AND_RETHROW()
+
+BOOST_FIXTURE_TEST_CASE( vote_batch, eosio_system_tester, * boost::unit_test::tolerance(1e-4) ) try {
+   create_accounts_with_resources( { N(defproducer1), N(defproducer2) } );
+   BOOST_REQUIRE_EQUAL( success(), regproducer( "defproducer1" ) );
+   BOOST_REQUIRE_EQUAL( success(), regproducer( "defproducer2" ) );
+
+   issue_and_transfer( "alice1111111", core_sym::from_string("1000.0000"),  config::system_account_name );
+   BOOST_REQUIRE_EQUAL( success(), stake( "alice1111111", core_sym::from_string("100.0000"), core_sym::from_string("50.0000") ) );
+   issue_and_transfer( "bob111111111", core_sym::from_string("1000.0000"),  config::system_account_name );
+   BOOST_REQUIRE_EQUAL( success(), stake( "bob111111111", core_sym::from_string("20.0000"), core_sym::from_string("10.0000") ) );
+
+   //every voter in the batch must sign
+   BOOST_REQUIRE_EXCEPTION( votebatch( { N(alice1111111) }, { vote_entry( N(alice1111111), { N(defproducer1) } ),
+                                                                vote_entry( N(bob111111111), { N(defproducer2) } ) } ),
+                            missing_auth_exception, fc_exception_message_starts_with("missing authority") );
+   BOOST_REQUIRE_EXCEPTION( votebatch( { N(alice1111111) }, { } ),
+                            eosio_assert_message_exception, eosio_assert_message_is("vote batch is empty") );
+
+   votebatch( { N(alice1111111), N(bob111111111) }, { vote_entry( N(alice1111111), { N(defproducer1), N(defproducer2) } ),
+                                                      vote_entry( N(bob111111111), { N(defproducer2) } ) } );
+   const double alice_weight = get_voter_info( "alice1111111" )["last_vote_weight"].as_double();
+   const double bob_weight = get_voter_info( "bob111111111" )["last_vote_weight"].as_double();
+   BOOST_TEST_REQUIRE( alice_weight > 0 );
+   BOOST_TEST_REQUIRE( bob_weight > 0 );
+   BOOST_TEST_REQUIRE( get_pending_producer_info( "defproducer1" )["total_votes"].as_double() == alice_weight );
+   BOOST_TEST_REQUIRE( get_pending_producer_info( "defproducer2" )["total_votes"].as_double() == alice_weight + bob_weight );
+
+   //a later entry moving a vote away nets out within the batch
+   votebatch( { N(bob111111111) }, { vote_entry( N(bob111111111), { N(defproducer1) } ),
+                                     vote_entry( N(bob111111111), { N(defproducer2) } ) } );
+   BOOST_TEST_REQUIRE( get_pending_producer_info( "defproducer1" )["total_votes"].as_double() == alice_weight );
+   BOOST_TEST_REQUIRE( get_pending_producer_info( "defproducer2" )["total_votes"].as_double() == alice_weight + bob_weight );
+
+   //producers added by any entry must be registered, even if a later entry removes them again
+   BOOST_REQUIRE_EQUAL( success(), push_action( N(defproducer1), N(unregprod), mvo()
+                                                ("producer",  "defproducer1")
+                        )
+   );
+   BOOST_REQUIRE_EXCEPTION( votebatch( { N(bob111111111) }, { vote_entry( N(bob111111111), { N(defproducer1) } ),
+                                                              vote_entry( N(bob111111111), { N(defproducer2) } ) } ),
+                            eosio_assert_message_exception, eosio_assert_message_is("producer defproducer1 is not currently registered") );
+
+} FC_LOG_AND_RETHROW()
+
 fc::mutable_variant_object config_to_variant( const eosio::chain::chain_config& config ) {
    return mutable_variant_object()
       ( "max_block_net_usage", config.max_block_net_usage )
@@ -2504,9 +2681,14 @@ BOOST_FIXTURE_TEST_CASE( multiple_namebids, eosio_system_tester ) try {
       const asset initial_names_balance = get_balance(N(eosio.names));
       BOOST_REQUIRE_EQUAL( success(),
                            bidname( "alice", "prefb", core_sym::from_string("1.1001") ) );
-      BOOST_REQUIRE_EQUAL( core_sym::from_string( "9997.9997" ), get_balance("bob") );
+      // bob's bid is queued until bob claims it
+      BOOST_REQUIRE_EQUAL( core_sym::from_string( "9996.9997" ), get_balance("bob") );
       BOOST_REQUIRE_EQUAL( core_sym::from_string( "9998.8999" ), get_balance("alice") );
+      BOOST_REQUIRE_EQUAL( initial_names_balance + core_sym::from_string("1.1001"), get_balance(N(eosio.names)) );
+      BOOST_REQUIRE_EQUAL( success(), claimrefund( N(bob) ) );
+      BOOST_REQUIRE_EQUAL( core_sym::from_string( "9997.9997" ), get_balance("bob") );
       BOOST_REQUIRE_EQUAL( initial_names_balance + core_sym::from_string("0.1001"), get_balance(N(eosio.names)) );
+      BOOST_REQUIRE_EQUAL( wasm_assert_msg( "refund not found" ), claimrefund( N(bob) ) );
    }
 
    // david outbids carl on prefd
@@ -2515,8 +2697,20 @@ BOOST_FIXTURE_TEST_CASE( multiple_namebids, eosio_system_tester ) try {
       BOOST_REQUIRE_EQUAL( core_sym::from_string( "10000.0000" ), get_balance("david") );
       BOOST_REQUIRE_EQUAL( success(),
                            bidname( "david", "prefd", core_sym::from_string("1.9900") ) );
-      BOOST_REQUIRE_EQUAL( core_sym::from_string( "9999.0000" ), get_balance("carl") );
+      BOOST_REQUIRE_EQUAL( core_sym::from_string( "9998.0000" ), get_balance("carl") );
       BOOST_REQUIRE_EQUAL( core_sym::from_string( "9998.0100" ), get_balance("david") );
+      // the queued refund is billed to eosio, not to the new high bidder
+      BOOST_REQUIRE_EQUAL( config::system_account_name, get_row_payer( config::system_account_name, config::system_account_name, N(refundqueue), N(carl) ) );
+      // anyone can settle carl's refund, it is paid to carl only
+      const asset alice_balance = get_balance("alice");
+      BOOST_REQUIRE_EQUAL( success(), claimrefund( N(alice), N(carl) ) );
+      BOOST_REQUIRE_EQUAL( core_sym::from_string( "9999.0000" ), get_balance("carl") );
+      BOOST_REQUIRE_EQUAL( alice_balance, get_balance("alice") );
+      BOOST_REQUIRE( get_row_by_account( config::system_account_name, config::system_account_name, N(refundqueue), N(carl) ).empty() );
+      BOOST_REQUIRE_EQUAL( wasm_assert_msg( "refund not found" ), claimrefund( N(david) ) );
+      // the highest open bid is cached in the global state
+      BOOST_REQUIRE_EQUAL( name("prefd"), get_global_state()["top_name_bid"]["newname"].as<name>() );
+      BOOST_REQUIRE_EQUAL( 19900, get_global_state()["top_name_bid"]["high_bid"].as<int64_t>() );
    }
 
    // eve outbids carl on prefe
@@ -2534,7 +2728,7 @@ BOOST_FIXTURE_TEST_CASE( multiple_namebids, eosio_system_tester ) try {
 
    // stake enough to go above the 15% threshold ~ total of ~~30M = 16 + 14 above (minstake to activate ~29M)
    stake_with_transfer( config::system_account_name, "alice", core_sym::from_string( "8000000.0000" ), core_sym::from_string( "8000000.0000" ) );
-   BOOST_REQUIRE_EQUAL(0, get_producer_info("producer")["unpaid_blocks"].as<uint32_t>());
+   BOOST_REQUIRE_EQUAL(0, get_pending_producer_info("producer")["unpaid_blocks"].as<uint32_t>());
    BOOST_REQUIRE_EQUAL( success(), vote( N(alice), { N(producer) } ) );
 
    activate_network();
@@ -2565,6 +2759,8 @@ BOOST_FIXTURE_TEST_CASE( multiple_namebids, eosio_system_tester ) try {
    // changing highest bid pushes auction closing time by 24 hours
    BOOST_REQUIRE_EQUAL( success(),
                         bidname( "eve",  "prefb", core_sym::from_string("2.1880") ) );
+   // prefd was closed, prefb now holds the highest open bid
+   BOOST_REQUIRE_EQUAL( name("prefb"), get_global_state()["top_name_bid"]["newname"].as<name>() );
 
    produce_block( fc::hours(22) );
    produce_blocks(2);
@@ -2639,7 +2835,7 @@ BOOST_FIXTURE_TEST_CASE( vote_producers_in_and_out, eosio_system_tester ) try {
          produce_blocks(1);
          ilog( "------ get pro----------" );
          wdump((p));
-         BOOST_TEST(0 == get_producer_info(p)["total_votes"].as<double>());
+         BOOST_TEST(0 == get_pending_producer_info(p)["total_votes"].as<double>());
       }
    }
 
@@ -2660,13 +2856,13 @@ BOOST_FIXTURE_TEST_CASE( vote_producers_in_and_out, eosio_system_tester ) try {
 
       bool all_21_produced = true;
       for (uint32_t i = 0; i < 21; ++i) {
-         if (0 == get_producer_info(producer_names[i])["unpaid_blocks"].as<uint32_t>()) {
+         if (0 == get_pending_producer_info(producer_names[i])["unpaid_blocks"].as<uint32_t>()) {
             all_21_produced = false;
          }
       }
       bool rest_didnt_produce = true;
       for (uint32_t i = 21; i < producer_names.size(); ++i) {
-         if (0 < get_producer_info(producer_names[i])["unpaid_blocks"].as<uint32_t>()) {
+         if (0 < get_pending_producer_info(producer_names[i])["unpaid_blocks"].as<uint32_t>()) {
             rest_didnt_produce = false;
          }
       }
@@ -2683,17 +2879,17 @@ BOOST_FIXTURE_TEST_CASE( vote_producers_in_and_out, eosio_system_tester ) try {
       
       BOOST_REQUIRE_EQUAL(success(), stake("producvoterd", core_sym::from_string("40000000.0000"), core_sym::from_string("40000000.0000")));
       BOOST_REQUIRE_EQUAL(success(), vote(N(producvoterd), v));
-      BOOST_REQUIRE_EQUAL(0, get_producer_info(producer_names[new_prod_index])["unpaid_blocks"].as<uint32_t>());
+      BOOST_REQUIRE_EQUAL(0, get_pending_producer_info(producer_names[new_prod_index])["unpaid_blocks"].as<uint32_t>());
       produce_blocks(4 * 24 * 21);
 
-      BOOST_REQUIRE(0 < get_producer_info(producer_names[new_prod_index])["unpaid_blocks"].as<uint32_t>());
-      const uint32_t initial_unpaid_blocks = get_producer_info(producer_names[voted_out_index])["unpaid_blocks"].as<uint32_t>();
+      BOOST_REQUIRE(0 < get_pending_producer_info(producer_names[new_prod_index])["unpaid_blocks"].as<uint32_t>());
+      const uint32_t initial_unpaid_blocks = get_pending_producer_info(producer_names[voted_out_index])["unpaid_blocks"].as<uint32_t>();
       produce_blocks(2 * 24 * 21);
-      // BOOST_REQUIRE_EQUAL(initial_unpaid_blocks, get_producer_info(producer_names[voted_out_index])["unpaid_blocks"].as<uint32_t>());
+      // BOOST_REQUIRE_EQUAL(initial_unpaid_blocks, get_pending_producer_info(producer_names[voted_out_index])["unpaid_blocks"].as<uint32_t>());
       produce_block(fc::hours(24));
       BOOST_REQUIRE_EQUAL(success(), vote(N(producvoterd), { producer_names[voted_out_index] }));
       produce_blocks(2 * 24 * 21); 
-      BOOST_REQUIRE(fc::crypto::public_key() != fc::crypto::public_key(get_producer_info(producer_names[voted_out_index])["producer_key"].as_string()));
+      BOOST_REQUIRE(fc::crypto::public_key() != fc::crypto::public_key(get_pending_producer_info(producer_names[voted_out_index])["producer_key"].as_string()));
       BOOST_REQUIRE_EQUAL(success(), push_action(producer_names[voted_out_index], N(claimrewards), mvo()("owner", producer_names[voted_out_index])));
    }
 
@@ -3123,7 +3319,7 @@ BOOST_FIXTURE_TEST_CASE( unstake_buy_rex, eosio_system_tester, * boost::unit_tes
       setup_producer_accounts(producer_names);
       for ( const auto& p: producer_names ) {
          BOOST_REQUIRE_EQUAL( success(), regproducer(p) );
-         BOOST_TEST_REQUIRE( 0 == get_producer_info(p)["total_votes"].as<double>() );
+         BOOST_TEST_REQUIRE( 0 == get_pending_producer_info(p)["total_votes"].as<double>() );
       }
       std::sort(producer_names.begin(), producer_names.end());
    }
@@ -3147,7 +3343,7 @@ BOOST_FIXTURE_TEST_CASE( unstake_buy_rex, eosio_system_tester, * boost::unit_tes
                            vote( alice, std::vector<account_name>(producer_names.begin(), producer_names.begin() + 30) ) );
       const asset init_eosio_stake_balance = get_balance( N(eosio.stake) );
       const auto init_voter_info = get_voter_info( alice );
-      const auto init_prod_info  = get_producer_info( producer_names[0] );
+      const auto init_prod_info  = get_pending_producer_info( producer_names[0] );
       BOOST_TEST_REQUIRE( init_prod_info["total_votes"].as_double() ==
                           stake2votes( asset( init_voter_info["staked"].as<int64_t>(), symbol{CORE_SYM} ) ) );
       produce_block( fc::days(4) );
@@ -3159,7 +3355,7 @@ BOOST_FIXTURE_TEST_CASE( unstake_buy_rex, eosio_system_tester, * boost::unit_tes
       BOOST_REQUIRE_EQUAL( tot_stake,                               get_balance( N(eosio.rex) ) );
       BOOST_REQUIRE_EQUAL( tot_stake,                               init_eosio_stake_balance - get_balance( N(eosio.stake) ) );
       auto current_voter_info = get_voter_info( alice );
-      auto current_prod_info  = get_producer_info( producer_names[0] );
+      auto current_prod_info  = get_pending_producer_info( producer_names[0] );
       BOOST_REQUIRE_EQUAL( init_voter_info["staked"].as<int64_t>(), current_voter_info["staked"].as<int64_t>() );
       BOOST_TEST_REQUIRE( current_prod_info["total_votes"].as_double() ==
                           stake2votes( asset( current_voter_info["staked"].as<int64_t>(), symbol{CORE_SYM} ) ) );
@@ -3343,7 +3539,9 @@ BOOST_FIXTURE_TEST_CASE( buy_sell_sell_rex, eosio_system_tester ) try {
    BOOST_REQUIRE_EQUAL( false,                                               get_rex_order_obj( alice ).is_null() );
    BOOST_REQUIRE_EQUAL( success(),                                           sellrex( alice, rex_tok ) );
    BOOST_REQUIRE_EQUAL( sellrex( alice, rex_tok ),                           wasm_assert_msg("insufficient funds for current and scheduled orders") );
-   BOOST_REQUIRE_EQUAL( ratio * payment.get_amount() - rex_tok.get_amount(), get_rex_order( alice )["rex_requested"].as<asset>().get_amount() );
+   // the queued order has been partially filled, the rest of alice's rex is still in it
+   BOOST_REQUIRE_EQUAL( get_rex_balance( alice ),                            get_rex_order( alice )["rex_requested"].as<asset>() );
+   BOOST_REQUIRE      ( get_rex_balance( alice ).get_amount() <              ratio * payment.get_amount() - rex_tok.get_amount() );
    BOOST_REQUIRE_EQUAL( success(),                                           consolidate( alice ) );
    BOOST_REQUIRE_EQUAL( 0,                                                   get_rex_balance_obj( alice )["rex_maturities"].get_array().size() );
 
@@ -3421,13 +3619,15 @@ BOOST_FIXTURE_TEST_CASE( buy_sell_claim_rex, eosio_system_tester ) try {
    BOOST_REQUIRE_EQUAL( init_carol_rex, get_rex_balance(carol) );
    BOOST_REQUIRE_EQUAL( init_alice_rex, get_rex_balance(alice) );
 
-   // now bob's, carol's and alice's sellrex orders have been queued
+   // now bob's, carol's and alice's sellrex orders have been queued, and bob's order
+   // has been partially filled against the remaining unlent tokens
    BOOST_REQUIRE_EQUAL( true,           get_rex_order(alice)["is_open"].as<bool>() );
    BOOST_REQUIRE_EQUAL( init_alice_rex, get_rex_order(alice)["rex_requested"].as<asset>() );
    BOOST_REQUIRE_EQUAL( 0,              get_rex_order(alice)["proceeds"].as<asset>().get_amount() );
    BOOST_REQUIRE_EQUAL( true,           get_rex_order(bob)["is_open"].as<bool>() );
-   BOOST_REQUIRE_EQUAL( init_bob_rex,   get_rex_order(bob)["rex_requested"].as<asset>() );
-   BOOST_REQUIRE_EQUAL( 0,              get_rex_order(bob)["proceeds"].as<asset>().get_amount() );
+   BOOST_REQUIRE      ( get_rex_order(bob)["rex_requested"].as<asset>() < init_bob_rex );
+   BOOST_REQUIRE_EQUAL( get_rex_balance(bob), get_rex_order(bob)["rex_requested"].as<asset>() );
+   BOOST_REQUIRE      ( 0 <             get_rex_order(bob)["proceeds"].as<asset>().get_amount() );
    BOOST_REQUIRE_EQUAL( true,           get_rex_order(carol)["is_open"].as<bool>() );
    BOOST_REQUIRE_EQUAL( init_carol_rex, get_rex_order(carol)["rex_requested"].as<asset>() );
    BOOST_REQUIRE_EQUAL( 0,              get_rex_order(carol)["proceeds"].as<asset>().get_amount() );
@@ -3439,8 +3639,8 @@ BOOST_FIXTURE_TEST_CASE( buy_sell_claim_rex, eosio_system_tester ) try {
    BOOST_REQUIRE_EQUAL( true,           get_rex_order(bob)["is_open"].as<bool>() );
    BOOST_REQUIRE_EQUAL( true,           get_rex_order(carol)["is_open"].as<bool>() );
 
-   // wait for 2 more hours, by now frank's loan has expired and there is enough balance in
-   // total_unlent to close some sellrex orders. only two are processed, bob's and carol's.
+   // wait for 2 more hours, by now some loans have expired and there is enough balance in
+   // total_unlent to close bob's sellrex order and partially fill carol's.
    // alices's order is still open.
    // an action is needed to trigger queue processing
    produce_block( fc::hours(2) );
@@ -3450,9 +3650,11 @@ BOOST_FIXTURE_TEST_CASE( buy_sell_claim_rex, eosio_system_tester ) try {
       auto trace = base_tester::push_action( config::system_account_name, N(rexexec), frank,
                                              mvo()("user", frank)("max", 2) );
       auto output = get_rexorder_result( trace );
-      BOOST_REQUIRE_EQUAL( output.size(),    1 );
+      BOOST_REQUIRE_EQUAL( output.size(),    2 );
       BOOST_REQUIRE_EQUAL( output[0].first,  bob );
-      BOOST_REQUIRE_EQUAL( output[0].second, get_rex_order(bob)["proceeds"].as<asset>() );
+      BOOST_REQUIRE      ( output[0].second < get_rex_order(bob)["proceeds"].as<asset>() );
+      BOOST_REQUIRE_EQUAL( output[1].first,  carol );
+      BOOST_REQUIRE_EQUAL( output[1].second, get_rex_order(carol)["proceeds"].as<asset>() );
    }
 
    {
@@ -3461,12 +3663,13 @@ BOOST_FIXTURE_TEST_CASE( buy_sell_claim_rex, eosio_system_tester ) try {
       BOOST_REQUIRE_EQUAL( 0,              get_rex_order(alice)["proceeds"].as<asset>().get_amount() );
 
       BOOST_REQUIRE_EQUAL( false,          get_rex_order(bob)["is_open"].as<bool>() );
-      BOOST_REQUIRE_EQUAL( init_bob_rex,   get_rex_order(bob)["rex_requested"].as<asset>() );
+      BOOST_REQUIRE_EQUAL( 0,              get_rex_balance(bob).get_amount() );
       BOOST_REQUIRE      ( 0 <             get_rex_order(bob)["proceeds"].as<asset>().get_amount() );
 
       BOOST_REQUIRE_EQUAL( true,           get_rex_order(carol)["is_open"].as<bool>() );
-      BOOST_REQUIRE_EQUAL( init_carol_rex, get_rex_order(carol)["rex_requested"].as<asset>() );
-      BOOST_REQUIRE_EQUAL( 0,              get_rex_order(carol)["proceeds"].as<asset>().get_amount() );
+      BOOST_REQUIRE      ( get_rex_order(carol)["rex_requested"].as<asset>() < init_carol_rex );
+      BOOST_REQUIRE_EQUAL( get_rex_balance(carol), get_rex_order(carol)["rex_requested"].as<asset>() );
+      BOOST_REQUIRE      ( 0 <             get_rex_order(carol)["proceeds"].as<asset>().get_amount() );
       BOOST_REQUIRE_EQUAL( wasm_assert_msg("rex loans are currently not available"),
                            rentcpu( frank, frank, core_sym::from_string("1.0000") ) );
    }
@@ -3480,7 +3683,7 @@ BOOST_FIXTURE_TEST_CASE( buy_sell_claim_rex, eosio_system_tester ) try {
       BOOST_REQUIRE_EQUAL( init_stake,     get_voter_info( carol )["staked"].as<int64_t>() );
       auto output1 = get_rexorder_result( trace1 );
       auto output2 = get_rexorder_result( trace2 );
-      BOOST_REQUIRE_EQUAL( 2,              output1.size() + output2.size() );
+      BOOST_REQUIRE_EQUAL( 3,              output1.size() + output2.size() );
 
       BOOST_REQUIRE_EQUAL( false,          get_rex_order_obj(alice).is_null() );
       BOOST_REQUIRE_EQUAL( true,           get_rex_order_obj(bob).is_null() );
@@ -3502,6 +3705,76 @@ BOOST_FIXTURE_TEST_CASE( buy_sell_claim_rex, eosio_system_tester ) try {
 
 } FC_LOG_AND_RETHROW()
 
+BOOST_FIXTURE_TEST_CASE( partially_filled_rex_order, eosio_system_tester ) try {
+
+   const asset init_balance = core_sym::from_string("100000.0000");
+   const std::vector<account_name> accounts = { N(aliceaccount), N(bobbyaccount), N(frankaccount) };
+   account_name alice = accounts[0], bob = accounts[1], frank = accounts[2];
+   setup_rex_accounts( accounts, init_balance );
+
+   BOOST_REQUIRE_EQUAL( success(), buyrex( alice, core_sym::from_string("50000.0000") ) );
+   BOOST_REQUIRE_EQUAL( success(), buyrex( bob,   core_sym::from_string("50000.0000") ) );
+   // frank's loan leaves less available unlent tokens than bob's REX is worth
+   BOOST_REQUIRE_EQUAL( success(), rentcpu( frank, frank, core_sym::from_string("40000.0000") ) );
+   produce_block( fc::days(5) );
+
+   const asset bob_rex = get_rex_balance(bob);
+   BOOST_REQUIRE_EQUAL( success(), sellrex( bob, bob_rex ) );
+   BOOST_REQUIRE_EQUAL( true,    get_rex_order(bob)["is_open"].as<bool>() );
+   BOOST_REQUIRE_EQUAL( bob_rex, get_rex_order(bob)["rex_requested"].as<asset>() );
+   BOOST_REQUIRE_EQUAL( 0,       get_rex_order(bob)["proceeds"].as<asset>().get_amount() );
+   BOOST_REQUIRE_EQUAL( bob_rex, get_rex_balance(bob) );
+
+   // the order is filled for the REX whose proceeds the available unlent tokens cover
+   const auto    rex_pool         = get_rex_pool();
+   const int64_t S0               = rex_pool["total_lendable"].as<asset>().get_amount();
+   const int64_t R0               = rex_pool["total_rex"].as<asset>().get_amount();
+   const int64_t available_unlent = rex_pool["total_unlent"].as<asset>().get_amount()
+                                    - ( eosio::chain::uint128_t(2) * rex_pool["total_lent"].as<asset>().get_amount() ) / 10;
+   const int64_t fillable         = ( eosio::chain::uint128_t(available_unlent) * R0 ) / S0;
+   const int64_t proceeds         = ( eosio::chain::uint128_t(fillable) * S0 ) / R0;
+   const int64_t bob_stake_value  = ( eosio::chain::uint128_t(bob_rex.get_amount()) * S0 ) / R0;
+   const int64_t stake_change     = bob_stake_value - proceeds - get_rex_vote_stake(bob).get_amount();
+   BOOST_REQUIRE( 0 < fillable && fillable < bob_rex.get_amount() );
+
+   const asset   bob_fund   = get_rex_fund(bob);
+   const int64_t bob_staked = get_voter_info(bob)["staked"].as<int64_t>();
+   {
+      auto trace  = base_tester::push_action( config::system_account_name, N(rexexec), alice,
+                                              mvo()("user", alice)("max", 2) );
+      auto output = get_rexorder_result( trace );
+      BOOST_REQUIRE_EQUAL( output.size(),   1 );
+      BOOST_REQUIRE_EQUAL( output[0].first, bob );
+      BOOST_REQUIRE_EQUAL( proceeds,        output[0].second.get_amount() );
+   }
+   auto order = get_rex_order(bob);
+   BOOST_REQUIRE_EQUAL( true,                           order["is_open"].as<bool>() );
+   BOOST_REQUIRE_EQUAL( bob_rex.get_amount() - fillable, order["rex_requested"].as<asset>().get_amount() );
+   BOOST_REQUIRE_EQUAL( proceeds,                       order["proceeds"].as<asset>().get_amount() );
+   BOOST_REQUIRE_EQUAL( stake_change,                   order["stake_change"].as<asset>().get_amount() );
+   BOOST_REQUIRE_EQUAL( bob_rex.get_amount() - fillable, get_rex_balance(bob).get_amount() );
+   BOOST_REQUIRE_EQUAL( bob_stake_value - proceeds,     get_rex_vote_stake(bob).get_amount() );
+   BOOST_REQUIRE_EQUAL( R0 - fillable,                  get_rex_pool()["total_rex"].as<asset>().get_amount() );
+   BOOST_REQUIRE_EQUAL( S0 - proceeds,                  get_rex_pool()["total_lendable"].as<asset>().get_amount() );
+   // proceeds are not paid out until bob acts
+   BOOST_REQUIRE_EQUAL( bob_fund,                       get_rex_fund(bob) );
+   BOOST_REQUIRE_EQUAL( bob_staked,                     get_voter_info(bob)["staked"].as<int64_t>() );
+
+   // available unlent tokens are used up, another run leaves the order as is
+   BOOST_REQUIRE_EQUAL( success(), rexexec( alice, 2 ) );
+   BOOST_REQUIRE_EQUAL( bob_rex.get_amount() - fillable, get_rex_order(bob)["rex_requested"].as<asset>().get_amount() );
+   BOOST_REQUIRE_EQUAL( proceeds,                       get_rex_order(bob)["proceeds"].as<asset>().get_amount() );
+
+   // canceling the order settles the filled part and keeps the unfilled REX
+   BOOST_REQUIRE_EQUAL( success(), push_action( bob, N(cnclrexorder), mvo()("owner", bob) ) );
+   BOOST_REQUIRE_EQUAL( true,                           get_rex_order_obj(bob).is_null() );
+   BOOST_REQUIRE_EQUAL( bob_fund.get_amount() + proceeds, get_rex_fund(bob).get_amount() );
+   BOOST_REQUIRE_EQUAL( bob_staked + stake_change,      get_voter_info(bob)["staked"].as<int64_t>() );
+   BOOST_REQUIRE_EQUAL( bob_rex.get_amount() - fillable, get_rex_balance(bob).get_amount() );
+   BOOST_REQUIRE_EQUAL( wasm_assert_msg("no sellrex order is scheduled"), push_action( bob, N(cnclrexorder), mvo()("owner", bob) ) );
+
+} FC_LOG_AND_RETHROW()
+
 
 BOOST_FIXTURE_TEST_CASE( rex_loans, eosio_system_tester ) try {
 
@@ -3554,6 +3827,10 @@ BOOST_FIXTURE_TEST_CASE( rex_loans, eosio_system_tester ) try {
    BOOST_REQUIRE_EQUAL( success(),           rentnet( alice, frank, payment ) );            // loan_num = 5
    BOOST_REQUIRE_EQUAL( 5,                   get_last_net_loan()["loan_num"].as_uint64() );
 
+   // loans were created after the loan wheel, there is nothing to backfill
+   BOOST_REQUIRE_EQUAL( wasm_assert_msg("must index at least one loan"), indexloans( bob, 0 ) );
+   BOOST_REQUIRE_EQUAL( wasm_assert_msg("loans are already indexed"),    indexloans( bob, 10 ) );
+
    auto loan_info         = get_cpu_loan(1);
    auto old_frank_balance = cur_frank_balance;
    cur_frank_balance      = get_rex_fund( frank );
@@ -3640,6 +3917,101 @@ BOOST_FIXTURE_TEST_CASE( rex_loans, eosio_system_tester ) try {
 } FC_LOG_AND_RETHROW()
 
 
+BOOST_FIXTURE_TEST_CASE( rex_loan_wheel_backfill, eosio_system_tester ) try {
+
+   const asset init_balance = core_sym::from_string("40000.0000");
+   const std::vector<account_name> accounts = { N(aliceaccount), N(bobbyaccount), N(emilyaccount), N(frankaccount) };
+   account_name alice = accounts[0], bob = accounts[1], emily = accounts[2], frank = accounts[3];
+   setup_rex_accounts( accounts, init_balance  );
+
+   BOOST_REQUIRE_EQUAL( success(), buyrex( alice, core_sym::from_string("25000.0000") ) );
+
+   auto loan_hour = [this]( const fc::variant& loan ) {
+      return uint32_t( microseconds_since_epoch_of_iso_string( loan["expiration"] ) / 1000000 / 3600 );
+   };
+   auto bucket_loans = []( const fc::variant& bucket, const char* resource ) {
+      std::vector<uint64_t> loans;
+      for ( const auto& entry : bucket[resource].get_array() ) {
+         loans.push_back( entry["loan_num"].as_uint64() );
+      }
+      return loans;
+   };
+
+   // create 2 cpu and 3 net loans, loans 1 and 3 are funded to be renewed once
+   const asset payment    = core_sym::from_string("30.0000");
+   const asset fund       = core_sym::from_string("35.0000");
+   const int64_t init_stake = get_cpu_limit( bob );
+   BOOST_REQUIRE_EQUAL( success(), rentcpu( frank, bob, payment ) );     // loan_num = 1
+   BOOST_REQUIRE_EQUAL( success(), rentcpu( alice, emily, payment ) );   // loan_num = 2
+   BOOST_REQUIRE_EQUAL( success(), rentnet( alice, emily, payment ) );   // loan_num = 3
+   BOOST_REQUIRE_EQUAL( success(), rentnet( alice, alice, payment ) );   // loan_num = 4
+   BOOST_REQUIRE_EQUAL( success(), rentnet( alice, frank, payment ) );   // loan_num = 5
+   BOOST_REQUIRE_EQUAL( success(), fundcpuloan( frank, 1, fund ) );
+   BOOST_REQUIRE_EQUAL( success(), fundnetloan( alice, 3, fund ) );
+
+   const uint32_t hour = loan_hour( get_cpu_loan(1) );
+   BOOST_REQUIRE_EQUAL( hour, loan_hour( get_net_loan(5) ) );
+   BOOST_REQUIRE_EQUAL( true, get_loan_index()["complete"].as<bool>() );
+   BOOST_REQUIRE( std::vector<uint64_t>({ 1, 2 })    == bucket_loans( get_loan_bucket( hour ), "cpu_loans" ) );
+   BOOST_REQUIRE( std::vector<uint64_t>({ 3, 4, 5 }) == bucket_loans( get_loan_bucket( hour ), "net_loans" ) );
+
+   // drop the loan wheel, as if the loans had been created before it existed
+   produce_block();
+   erase_table( config::system_account_name, config::system_account_name, N(loanwheel) );
+   erase_table( config::system_account_name, config::system_account_name, N(loanidx) );
+   produce_block();
+   BOOST_REQUIRE( get_loan_index().is_null() );
+   BOOST_REQUIRE( get_loan_bucket( hour ).is_null() );
+
+   // the first batch indexes both cpu loans and crosses into the net loans
+   BOOST_REQUIRE_EQUAL( success(), indexloans( bob, 3 ) );
+   auto index_state = get_loan_index();
+   BOOST_REQUIRE_EQUAL( false, index_state["complete"].as<bool>() );
+   BOOST_REQUIRE_EQUAL( true,  index_state["net"].as<bool>() );
+   BOOST_REQUIRE_EQUAL( 4,     index_state["cursor"].as_uint64() );
+   BOOST_REQUIRE( std::vector<uint64_t>({ 1, 2 }) == bucket_loans( get_loan_bucket( hour ), "cpu_loans" ) );
+   BOOST_REQUIRE( std::vector<uint64_t>({ 3 })    == bucket_loans( get_loan_bucket( hour ), "net_loans" ) );
+
+   // while the wheel is incomplete, expired loans are found through the expiration indexes
+   // and renewed loans move to the bucket of their new expiration hour
+   produce_block( fc::hours(30*24 + 1) );
+   BOOST_REQUIRE_EQUAL( success(), sellrex( alice, asset::from_string("1.0000 REX") ) );
+   BOOST_REQUIRE_EQUAL( false, get_cpu_loan(1).is_null() );
+   BOOST_REQUIRE_EQUAL( true,  get_cpu_loan(2).is_null() );
+   BOOST_REQUIRE_EQUAL( false, get_net_loan(3).is_null() );
+   BOOST_REQUIRE_EQUAL( true,  get_net_loan(4).is_null() );
+   BOOST_REQUIRE_EQUAL( false, get_net_loan(5).is_null() );
+   const uint32_t renewed_hour = loan_hour( get_cpu_loan(1) );
+   BOOST_REQUIRE_EQUAL( hour + 30*24,  renewed_hour );
+   BOOST_REQUIRE_EQUAL( renewed_hour, loan_hour( get_net_loan(3) ) );
+   BOOST_REQUIRE( get_loan_bucket( hour ).is_null() );
+   BOOST_REQUIRE( std::vector<uint64_t>({ 1 }) == bucket_loans( get_loan_bucket( renewed_hour ), "cpu_loans" ) );
+   BOOST_REQUIRE( std::vector<uint64_t>({ 3 }) == bucket_loans( get_loan_bucket( renewed_hour ), "net_loans" ) );
+   BOOST_REQUIRE_EQUAL( 4, get_loan_index()["cursor"].as_uint64() );
+
+   // the backfill resumes at the cursor and lists the loan that has not been processed yet
+   BOOST_REQUIRE_EQUAL( success(), indexloans( bob, 10 ) );
+   BOOST_REQUIRE_EQUAL( true, get_loan_index()["complete"].as<bool>() );
+   BOOST_REQUIRE( bucket_loans( get_loan_bucket( hour ), "cpu_loans" ).empty() );
+   BOOST_REQUIRE( std::vector<uint64_t>({ 5 }) == bucket_loans( get_loan_bucket( hour ), "net_loans" ) );
+   BOOST_REQUIRE_EQUAL( wasm_assert_msg("loans are already indexed"), indexloans( bob, 10 ) );
+
+   // from now on expired loans are read from the wheel
+   BOOST_REQUIRE_EQUAL( success(), rexexec( bob, 10 ) );
+   BOOST_REQUIRE_EQUAL( true, get_net_loan(5).is_null() );
+   BOOST_REQUIRE( get_loan_bucket( hour ).is_null() );
+   BOOST_REQUIRE_EQUAL( false, get_loan_bucket( renewed_hour ).is_null() );
+
+   // renewed loans don't have enough funds left and are closed from their new bucket
+   produce_block( fc::hours(30*24) );
+   BOOST_REQUIRE_EQUAL( success(), rexexec( bob, 10 ) );
+   BOOST_REQUIRE_EQUAL( true, get_cpu_loan(1).is_null() );
+   BOOST_REQUIRE_EQUAL( true, get_net_loan(3).is_null() );
+   BOOST_REQUIRE( get_loan_bucket( renewed_hour ).is_null() );
+   BOOST_REQUIRE_EQUAL( init_stake, get_cpu_limit( bob ) );
+
+} FC_LOG_AND_RETHROW()
+
 BOOST_FIXTURE_TEST_CASE( rex_loan_checks, eosio_system_tester ) try {
 
    const int64_t ratio        = 10000;
@@ -3862,7 +4234,7 @@ BOOST_FIXTURE_TEST_CASE( rex_maturity, eosio_system_tester ) try {
       BOOST_REQUIRE_EQUAL( rex_bucket1.get_amount(), rex_balance["matured_rex"].as<int64_t>() );
       BOOST_REQUIRE_EQUAL( success(),                consolidate( bob ) );
       rex_balance = get_rex_balance_obj( bob );
-      BOOST_REQUIRE_EQUAL( rex_bucket1.get_amount(), rex_balance["matured_rex"].as<int64_t>() + 20 );
+      BOOST_REQUIRE_EQUAL( get_rex_order( bob )["rex_requested"].as<asset>().get_amount(), rex_balance["matured_rex"].as<int64_t>() );
       BOOST_REQUIRE_EQUAL( success(),                cancelrexorder( bob ) );
       BOOST_REQUIRE_EQUAL( success(),                consolidate( bob ) );
       rex_balance = get_rex_balance_obj( bob );
@@ -4036,7 +4408,7 @@ BOOST_FIXTURE_TEST_CASE( rex_savings, eosio_system_tester ) try {
       BOOST_REQUIRE_EQUAL( success(),                       cancelrexorder( alice ) );
       BOOST_REQUIRE_EQUAL( success(),                       mvtosavings( alice, asset( rex_bucket_amount / 10, rex_sym ) ) );
       auto rb = get_rex_balance_obj( alice );
-      BOOST_REQUIRE_EQUAL( rb["matured_rex"].as<int64_t>(), 8 * rex_bucket_amount / 10 );
+      BOOST_REQUIRE_EQUAL( rb["matured_rex"].as<int64_t>(), get_rex_balance( alice ).get_amount() - 2 * rex_bucket_amount / 10 );
       BOOST_REQUIRE_EQUAL( success(),                       mvfrsavings( alice, asset( 2 * rex_bucket_amount / 10, rex_sym ) ) );
       produce_block( fc::days(31) );
       BOOST_REQUIRE_EQUAL( success(),                       sellrex( alice, get_rex_balance( alice ) ) );
@@ -4123,7 +4495,7 @@ BOOST_FIXTURE_TEST_CASE( update_rex, eosio_system_tester, * boost::unit_test::to
       setup_producer_accounts(producer_names);
       for ( const auto& p: producer_names ) {
          BOOST_REQUIRE_EQUAL( success(), regproducer(p) );
-         BOOST_TEST_REQUIRE( 0 == get_producer_info(p)["total_votes"].as<double>() );
+         BOOST_TEST_REQUIRE( 0 == get_pending_producer_info(p)["total_votes"].as<double>() );
       }
       std::sort(producer_names.begin(), producer_names.end());
    }
@@ -4134,19 +4506,19 @@ BOOST_FIXTURE_TEST_CASE( update_rex, eosio_system_tester, * boost::unit_test::to
                         vote( alice, std::vector<account_name>(producer_names.begin(), producer_names.begin() + 30) ) );
 
    BOOST_TEST_REQUIRE( stake2votes( asset( get_voter_info( alice )["staked"].as<int64_t>(), symbol{CORE_SYM} ) )
-                       == get_producer_info(producer_names[0])["total_votes"].as<double>() );
+                       == get_pending_producer_info(producer_names[0])["total_votes"].as<double>() );
    BOOST_TEST_REQUIRE( stake2votes( asset( get_voter_info( alice )["staked"].as<int64_t>(), symbol{CORE_SYM} ) )
-                       == get_producer_info(producer_names[20])["total_votes"].as<double>() );
+                       == get_pending_producer_info(producer_names[20])["total_votes"].as<double>() );
 
    BOOST_REQUIRE_EQUAL( success(), updaterex( alice ) );
    produce_block( fc::days(20) );
 
    //NOTE: TELOS doesn't have "vote decay", this test has been rewritten to reflect telos voting logic. 
-   BOOST_TEST_REQUIRE( get_producer_info(producer_names[20])["total_votes"].as<double>()
+   BOOST_TEST_REQUIRE( get_pending_producer_info(producer_names[20])["total_votes"].as<double>()
                        == stake2votes( asset( get_voter_info( alice )["staked"].as<int64_t>(), symbol{CORE_SYM} ) ) );
    BOOST_REQUIRE_EQUAL( success(), updaterex( alice ) );
    BOOST_TEST_REQUIRE( stake2votes( asset( get_voter_info( alice )["staked"].as<int64_t>(), symbol{CORE_SYM} ) )
-                       == get_producer_info(producer_names[20])["total_votes"].as<double>() );
+                       == get_pending_producer_info(producer_names[20])["total_votes"].as<double>() );
 
    const asset   init_rex             = get_rex_balance( alice );
    const auto    current_rex_pool     = get_rex_pool();
@@ -4160,7 +4532,7 @@ BOOST_FIXTURE_TEST_CASE( update_rex, eosio_system_tester, * boost::unit_test::to
    BOOST_REQUIRE_EQUAL( 3 * init_alice_rex_stake,                        4 * get_rex_vote_stake( alice ).get_amount() );
    BOOST_REQUIRE_EQUAL( get_voter_info( alice )["staked"].as<int64_t>(), init_stake + get_rex_vote_stake(alice).get_amount() );
    BOOST_TEST_REQUIRE( stake2votes( asset( get_voter_info( alice )["staked"].as<int64_t>(), symbol{CORE_SYM} ) )
-                       == get_producer_info(producer_names[0])["total_votes"].as<double>() );
+                       == get_pending_producer_info(producer_names[0])["total_votes"].as<double>() );
 
    produce_block( fc::days(31) );
    BOOST_REQUIRE_EQUAL( success(), sellrex( alice, get_rex_balance( alice ) ) );
@@ -4189,7 +4561,7 @@ BOOST_FIXTURE_TEST_CASE( update_rex_vote, eosio_system_tester, * boost::unit_tes
       setup_producer_accounts(producer_names);
       for ( const auto& p: producer_names ) {
          BOOST_REQUIRE_EQUAL( success(), regproducer(p) );
-         BOOST_TEST_REQUIRE( 0 == get_producer_info(p)["total_votes"].as<double>() );
+         BOOST_TEST_REQUIRE( 0 == get_pending_producer_info(p)["total_votes"].as<double>() );
       }
       std::sort(producer_names.begin(), producer_names.end());
    }
@@ -4224,9 +4596,9 @@ BOOST_FIXTURE_TEST_CASE( update_rex_vote, eosio_system_tester, * boost::unit_tes
    BOOST_REQUIRE_EQUAL( (purchase + rent).get_amount(),         get_voter_info(alice)["staked"].as<int64_t>() - init_stake_amount );
    BOOST_REQUIRE_EQUAL( purchase + rent,                        get_rex_vote_stake(alice) );
    BOOST_TEST_REQUIRE ( stake2votes(purchase + rent + init_stake) ==
-                        get_producer_info(producer_names[0])["total_votes"].as_double() );
+                        get_pending_producer_info(producer_names[0])["total_votes"].as_double() );
    BOOST_TEST_REQUIRE ( stake2votes(purchase + rent + init_stake) ==
-                        get_producer_info(producer_names[20])["total_votes"].as_double() );
+                        get_pending_producer_info(producer_names[20])["total_votes"].as_double() );
 
    const asset to_net_stake = core_sym::from_string("60.0000");
    const asset to_cpu_stake = core_sym::from_string("40.0000");
@@ -4235,12 +4607,12 @@ BOOST_FIXTURE_TEST_CASE( update_rex_vote, eosio_system_tester, * boost::unit_tes
    BOOST_REQUIRE_EQUAL( success(),                              stake( alice, alice, to_net_stake, to_cpu_stake ) );
    BOOST_REQUIRE_EQUAL( purchase + rent + rent,                 get_rex_vote_stake(alice) );
    BOOST_TEST_REQUIRE ( stake2votes(init_stake + purchase + rent + rent + to_net_stake + to_cpu_stake) ==
-                        get_producer_info(producer_names[0])["total_votes"].as_double() );
+                        get_pending_producer_info(producer_names[0])["total_votes"].as_double() );
    BOOST_REQUIRE_EQUAL( success(),                              rentcpu( emily, bob, rent ) );
    BOOST_REQUIRE_EQUAL( success(),                              unstake( alice, alice, to_net_stake, to_cpu_stake ) );
    BOOST_REQUIRE_EQUAL( purchase + rent + rent + rent,          get_rex_vote_stake(alice) );
    BOOST_TEST_REQUIRE ( stake2votes(init_stake + purchase + rent + rent + rent) ==
-                        get_producer_info(producer_names[0])["total_votes"].as_double() );
+                        get_pending_producer_info(producer_names[0])["total_votes"].as_double() );
 
 } FC_LOG_AND_RETHROW()
 
@@ -100,6 +100,13 @@ public:
       );
    }
 
+   action_result bulktransfer( account_name from, const fc::variants& transfers ) {
+      return push_action( from, N(bulktransfer), mvo()
+           ( "from", from)
+           ( "transfers", transfers)
+      );
+   }
+
    action_result open( account_name owner,
                        const string& symbolname,
                        account_name ram_payer    ) {
@@ -346,6 +353,44 @@ BOOST_FIXTURE_TEST_CASE( transfer_tests, eosio_token_tester ) try {
 
 } FC_LOG_AND_RETHROW()
 
+BOOST_FIXTURE_TEST_CASE( bulktransfer_tests, eosio_token_tester ) try {
+
+   auto token = create( N(alice), asset::from_string("1000 CERO"));
+   produce_blocks(1);
+
+   issue( N(alice), asset::from_string("1000 CERO"), "hola" );
+
+   BOOST_REQUIRE_EQUAL( success(),
+      bulktransfer( N(alice), { mvo()("to", "bob")("quantity", "300 CERO")("memo", "hola"),
+                                mvo()("to", "carol")("quantity", "200 CERO")("memo", "") } )
+   );
+
+   REQUIRE_MATCHING_OBJECT( get_account(N(alice), "0,CERO"), mvo()("balance", "500 CERO") );
+   REQUIRE_MATCHING_OBJECT( get_account(N(bob), "0,CERO"), mvo()("balance", "300 CERO") );
+   REQUIRE_MATCHING_OBJECT( get_account(N(carol), "0,CERO"), mvo()("balance", "200 CERO") );
+
+   //the whole batch fails if the sum is not covered
+   BOOST_REQUIRE_EQUAL( wasm_assert_msg( "overdrawn balance" ),
+      bulktransfer( N(alice), { mvo()("to", "bob")("quantity", "300 CERO")("memo", ""),
+                                mvo()("to", "carol")("quantity", "201 CERO")("memo", "") } )
+   );
+   BOOST_REQUIRE_EQUAL( wasm_assert_msg( "cannot transfer to self" ),
+      bulktransfer( N(alice), { mvo()("to", "alice")("quantity", "1 CERO")("memo", "") } )
+   );
+   BOOST_REQUIRE_EQUAL( wasm_assert_msg( "must transfer positive quantity" ),
+      bulktransfer( N(alice), { mvo()("to", "bob")("quantity", "0 CERO")("memo", "") } )
+   );
+   BOOST_REQUIRE_EQUAL( wasm_assert_msg( "no transfers" ), bulktransfer( N(alice), {} ) );
+   REQUIRE_MATCHING_OBJECT( get_account(N(alice), "0,CERO"), mvo()("balance", "500 CERO") );
+
+   //only the issuer can bypass the transfer notifications
+   BOOST_REQUIRE_EQUAL( wasm_assert_msg( "only the issuer can bulk transfer" ),
+      bulktransfer( N(bob), { mvo()("to", "carol")("quantity", "1 CERO")("memo", "") } )
+   );
+   REQUIRE_MATCHING_OBJECT( get_account(N(bob), "0,CERO"), mvo()("balance", "300 CERO") );
+
+} FC_LOG_AND_RETHROW()
+
 BOOST_FIXTURE_TEST_CASE( open_tests, eosio_token_tester ) try {
 
    auto token = create( N(alice), asset::from_string("1000 CERO"));
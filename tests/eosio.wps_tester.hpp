@@ -49,6 +49,16 @@ class eosio_wps_tester : public eosio_trail_tester
         return push_transaction(trx);
     }
 
+    transaction_trace_ptr bulktransfer(account_name from, const fc::variants& transfers)
+    {
+        signed_transaction trx;
+        trx.actions.emplace_back(get_action(N(eosio.token), N(bulktransfer), vector<permission_level>{{from, config::active_name}},
+                                            mvo()("from", from)("transfers", transfers)));
+        set_transaction_headers(trx);
+        trx.sign(get_private_key(from, "active"), control->get_chain_id());
+        return push_transaction(trx);
+    }
+
     transaction_trace_ptr getdeposit(account_name owner)
     {
         signed_transaction trx;
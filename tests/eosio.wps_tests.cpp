@@ -66,6 +66,34 @@ BOOST_FIXTURE_TEST_CASE( deposit_system, eosio_wps_tester) try {
 	}
 } FC_LOG_AND_RETHROW()
 
+BOOST_FIXTURE_TEST_CASE( bulk_deposit, eosio_wps_tester ) try {
+	asset contract_balance = get_currency_balance(N(eosio.token), symbol(4, "TLOS"), N(eosio.saving));
+	asset voter_balance = get_currency_balance(N(eosio.token), symbol(4, "TLOS"), test_voters[0].value);
+	BOOST_REQUIRE_EQUAL(true, get_deposit(N(eosio)).is_null());
+
+	// only the entry paid to eosio.saving is a deposit of the sender
+	bulktransfer(N(eosio), {
+		mvo()("to", "eosio.saving")("quantity", "30.0000 TLOS")("memo", "worker share"),
+		mvo()("to", test_voters[0].to_string())("quantity", "5.0000 TLOS")("memo", "")
+	});
+	produce_blocks( 2 );
+	BOOST_REQUIRE_EQUAL(contract_balance + asset::from_string("30.0000 TLOS"), get_currency_balance(N(eosio.token), symbol(4, "TLOS"), N(eosio.saving)));
+	BOOST_REQUIRE_EQUAL(voter_balance + asset::from_string("5.0000 TLOS"), get_currency_balance(N(eosio.token), symbol(4, "TLOS"), test_voters[0].value));
+	REQUIRE_MATCHING_OBJECT(get_deposit(N(eosio)), mvo()
+		("owner", "eosio")
+		("escrow", "30.0000 TLOS")
+	);
+	BOOST_REQUIRE_EQUAL(true, get_deposit(test_voters[0].value).is_null());
+
+	// a later transfer adds to the same deposit
+	transfer(N(eosio), N(eosio.saving), asset::from_string("10.0000 TLOS"), "WPS deposit");
+	produce_blocks( 2 );
+	REQUIRE_MATCHING_OBJECT(get_deposit(N(eosio)), mvo()
+		("owner", "eosio")
+		("escrow", "40.0000 TLOS")
+	);
+} FC_LOG_AND_RETHROW()
+
 BOOST_FIXTURE_TEST_CASE( ballot_id_and_fee, eosio_wps_tester ) try {
    register_voters(test_voters, 0, 1, symbol(4, "VOTE"));
 